@@ -56,7 +56,7 @@ class NormalizationInfo:
                 new_outputs.append(output_not)
             else:
                 new_outputs.append(output)
-        circuit._outputs = new_outputs
+        circuit.set_outputs(new_outputs)
 
     def _sort_outputs(self, truth_table: RawTruthTable) -> RawTruthTable:
         enumerated_truth_tables = list(enumerate(truth_table))
@@ -90,7 +90,7 @@ class NormalizationInfo:
         original_outputs = ['' for _ in self.mapping]
         for i, mapped_index in enumerate(self.mapping):
             original_outputs[i] = circuit.outputs[mapped_index]
-        circuit._outputs = original_outputs
+        circuit.set_outputs(original_outputs)
 
 
 def _negate_gate(circuit: Circuit, gate: Label) -> Label:
@@ -4,6 +4,7 @@ a Circuit."""
 from .boolean_function import Function, FunctionModel
 from .circuit import Circuit, Gate, gate
 from .logic import DontCare, TriValue
+from .packed_truth_table import PackedTruthTable, write_packed_truth_table
 from .python_function import PyFunction, PyFunctionModel
 from .truth_table import TruthTable, TruthTableModel
 
@@ -20,6 +21,9 @@ __all__ = [
     # truth_table.py
     'TruthTable',
     'TruthTableModel',
+    # packed_truth_table.py
+    'PackedTruthTable',
+    'write_packed_truth_table',
     # circuit/
     'Circuit',
     'Gate',
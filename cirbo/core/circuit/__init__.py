@@ -1,4 +1,5 @@
 from cirbo.core.circuit.circuit import Circuit
+from cirbo.core.circuit.compiled import CompiledCircuit
 from cirbo.core.circuit.gate import (
     ALWAYS_FALSE,
     ALWAYS_TRUE,
@@ -23,11 +24,17 @@ from cirbo.core.circuit.gate import (
     RNOT,
     XOR,
 )
+from cirbo.core.circuit.hierarchy import HierarchicalCircuit, Instance
+from cirbo.core.circuit.metrics import StructuralMetrics
 from cirbo.core.circuit.operators import GateState, Undefined
 from cirbo.core.circuit.transformer import Transformer
 
 __all__ = [
     'Circuit',
+    'CompiledCircuit',
+    'HierarchicalCircuit',
+    'Instance',
+    'StructuralMetrics',
     'Gate',
     'Label',
     'GateType',
@@ -17,6 +17,7 @@ import typing_extensions as tp_ext
 
 from cirbo.core.boolean_function import Function, RawTruthTable
 from cirbo.core.circuit import gate
+from cirbo.core.circuit.compiled import CompiledCircuit
 from cirbo.core.circuit.converters import convert_gate
 from cirbo.core.circuit.exceptions import (
     CircuitGateAlreadyExistsError,
@@ -31,6 +32,11 @@ from cirbo.core.circuit.exceptions import (
     ReplaceSubcircuitError,
     TraverseMethodError,
 )
+from cirbo.core.circuit.metrics import (
+    compute_structural_metrics,
+    FREE_GATE_TYPES,
+    StructuralMetrics,
+)
 from cirbo.core.circuit.operators import GateState, Undefined
 from cirbo.core.circuit.utils import input_iterator_with_fixed_sum, order_list
 from cirbo.core.circuit.validation import (
@@ -46,6 +52,10 @@ logger = logging.getLogger(__name__)
 
 __all__ = ['Circuit', 'Block']
 
+# Number of inputs, on all assignments of which the circuit is simulated at once when
+# its truth table is computed.
+_TRUTH_TABLE_BLOCK_INPUTS = 16
+
 
 class TraverseMode(enum.Enum):
     DFS = 'DFS'
@@ -247,6 +257,19 @@ class Circuit(Function):
         self._gates: dict[gate.Label, gate.Gate] = {}
         self._gate_to_users: dict[gate.Label, list[gate.Label]] = {}
         self._blocks: dict[gate.Label, Block] = {}
+        # Modification counter and data derived from the circuit, computed for the
+        # current version only.
+        self._version: int = 0
+        self._cache: dict[tp.Hashable, tp.Any] = {}
+
+    @property
+    def version(self) -> int:
+        """
+        :return: modification counter, which is incremented by each change of gates,
+            inputs or outputs of the circuit.
+
+        """
+        return self._version
 
     @property
     def inputs(self) -> list[gate.Label]:
@@ -312,19 +335,17 @@ class Circuit(Function):
 
         """
         if exclusion_list is None:
-            exclusion_list = [
-                gate.INPUT,
-                gate.NOT,
-                gate.LNOT,
-                gate.RNOT,
-                gate.IFF,
-                gate.LIFF,
-                gate.RIFF,
-                gate.ALWAYS_FALSE,
-                gate.ALWAYS_TRUE,
-            ]
+            exclusion_list = FREE_GATE_TYPES
+        gate_counts = self._cached(
+            'gate_counts',
+            lambda: collections.Counter(
+                _gate.gate_type for _gate in self._gates.values()
+            ),
+        )
         return sum(
-            1 for _gate in self._gates.values() if _gate.gate_type not in exclusion_list
+            count
+            for gate_type, count in gate_counts.items()
+            if gate_type not in exclusion_list
         )
 
     def input_at_index(self, idx: int) -> gate.Label:
@@ -625,8 +646,6 @@ class Circuit(Function):
                 if other.get_gate(gate_label).gate_type != gate.INPUT:
                     raise CreateBlockError()
 
-        copy_order_self_inputs = list(self._inputs)
-
         prefix: str = ''
         if name != '' and add_prefix:
             prefix = name + '@'
@@ -635,53 +654,45 @@ class Circuit(Function):
         for i, old_name in enumerate(other_connectors):
             mapping[old_name] = this_connectors[i]
 
+        # Gates of `other` are spliced in bulk: labels are checked once, and gates
+        # with remapped operands are inserted without per-gate validation.
         old_to_new_names = copy.copy(mapping)
-        gates_for_block: set[gate.Label] = set()
-        for _gate in other.top_sort(inverse=True):
-            cur_gate: gate.Gate = _gate
-            if cur_gate.label not in mapping:
-                new_label: gate.Label = prefix + cur_gate.label
-                old_to_new_names[cur_gate.label] = new_label
-                self.emplace_gate(
-                    label=new_label,
-                    gate_type=cur_gate.gate_type,
-                    operands=tuple(
-                        old_to_new_names[operand] for operand in cur_gate.operands
-                    ),
-                )
-                if cur_gate.gate_type != gate.INPUT:
-                    gates_for_block.add(new_label)
-            else:
-                if right_connect:
-                    self._gates[old_to_new_names[cur_gate.label]] = gate.Gate(
-                        label=old_to_new_names[cur_gate.label],
-                        gate_type=cur_gate.gate_type,
-                        operands=tuple(
-                            old_to_new_names[operand] for operand in cur_gate.operands
-                        ),
-                    )
-
-        self.set_outputs(
-            [output for output in self._outputs if output not in this_connectors]
-            + [
-                old_to_new_names[output]
-                for output in other.outputs
-                if output not in other_connectors
-            ]
+        for label in other._gates:
+            if label not in mapping:
+                old_to_new_names[label] = prefix + label
+                check_label_doesnt_exist(old_to_new_names[label], self)
+
+        gates_for_block: list[gate.Label] = []
+        for cur_gate in other.top_sort(inverse=True):
+            if cur_gate.label in mapping and not right_connect:
+                continue
+            new_label = old_to_new_names[cur_gate.label]
+            operands = tuple(old_to_new_names[operand] for operand in cur_gate.operands)
+            self._gates[new_label] = gate.Gate(new_label, cur_gate.gate_type, operands)
+            for operand in operands:
+                self._gate_to_users.setdefault(operand, []).append(new_label)
+            if cur_gate.label not in mapping and cur_gate.gate_type != gate.INPUT:
+                gates_for_block.append(new_label)
+
+        connected = set(this_connectors)
+        other_connected = set(other_connectors)
+        self._outputs = [output for output in self._outputs if output not in connected]
+        self._outputs.extend(
+            old_to_new_names[output]
+            for output in other.outputs
+            if output not in other_connected
         )
-
-        self.set_inputs(
-            [
-                _input
-                for _input in copy_order_self_inputs
-                if self._gates[_input].gate_type == gate.INPUT
-            ]
-            + [
-                old_to_new_names[_input]
-                for _input in other.inputs
-                if _input not in other_connectors
-            ]
+        self._inputs = [
+            _input
+            for _input in self._inputs
+            if self._gates[_input].gate_type == gate.INPUT
+        ]
+        self._inputs.extend(
+            old_to_new_names[_input]
+            for _input in other.inputs
+            if _input not in other_connected
         )
+        self._mark_modified()
 
         for block in other.blocks.values():
             new_block_name = prefix + block.name
@@ -699,7 +710,7 @@ class Circuit(Function):
                 name=name,
                 owner=self,
                 inputs=[old_to_new_names[_input] for _input in other.inputs],
-                gates=list(gates_for_block),
+                gates=gates_for_block,
                 outputs=[old_to_new_names[_output] for _output in other.outputs],
             )
 
@@ -968,6 +979,7 @@ class Circuit(Function):
                 self._gate_to_users[gate_label] = list_users
             else:
                 self._gate_to_users[gate_label].extend(list_users)
+        self._mark_modified()
 
         check_circuit_has_no_cycles(self)
 
@@ -1023,17 +1035,20 @@ class Circuit(Function):
         for block in self.blocks.values():
             block._rename_gate(old_label, new_label)
 
+        self._mark_modified()
         return self
 
     def mark_as_output(self, label: gate.Label) -> None:
         """Mark as output a gate and append it to the end of `self._outputs`."""
         check_gates_exist((label,), self)
         self._outputs.append(label)
+        self._mark_modified()
 
     def set_outputs(self, outputs: tp.Sequence[gate.Label]) -> None:
         """Set new outputs in the circuit."""
         check_gates_exist(outputs, self)
         self._outputs = list(outputs)
+        self._mark_modified()
 
     def set_inputs(self, inputs: tp.Sequence[gate.Label]) -> None:
         """Set new order of inputs in the circuit."""
@@ -1049,6 +1064,7 @@ class Circuit(Function):
             new_inputs.append(_input)
 
         self._inputs = list(new_inputs)
+        self._mark_modified()
 
     def add_inputs(self, inputs: tp.Sequence[gate.Label]) -> None:
         """Add new inputs in the circuit."""
@@ -1077,6 +1093,7 @@ class Circuit(Function):
                     raise GateNotInputError()
                 self._gates[input_label] = gate.Gate(input_label, new_type)
                 self._inputs.remove(input_label)
+                self._mark_modified()
 
         _replace_inputs(inputs_to_true, gate.ALWAYS_TRUE)
         _replace_inputs(inputs_to_false, gate.ALWAYS_FALSE)
@@ -1096,6 +1113,7 @@ class Circuit(Function):
 
         """
         self._inputs = order_list(inputs, self._inputs)
+        self._mark_modified()
         return self
 
     def order_outputs(self, outputs: tp.Sequence[gate.Label]) -> tp_ext.Self:
@@ -1111,6 +1129,7 @@ class Circuit(Function):
 
         """
         self._outputs = order_list(outputs, self._outputs)
+        self._mark_modified()
         return self
 
     def top_sort(self, *, inverse: bool = False) -> tp.Iterable[gate.Gate]:
@@ -1124,6 +1143,54 @@ class Circuit(Function):
         if self.size == 0:
             return
 
+        order = self._cached(('top_sort', inverse), lambda: self._top_sort(inverse))
+        for label in order:
+            yield self._gates[label]
+
+    def get_gate_levels(self) -> dict[gate.Label, int]:
+        """
+        Level of a gate is the length of the longest path from inputs (or constant
+        gates) to it, so inputs are on level 0. Result is cached until the circuit is
+        modified and should not be modified.
+
+        :return: mapping of gate labels to their levels.
+
+        """
+        return self._cached('levels', self._gate_levels)
+
+    def get_fanout_counts(self) -> dict[gate.Label, int]:
+        """
+        Fanout of a gate is the number of its occurrences as an operand of other gates.
+        Result is cached until the circuit is modified and should not be modified.
+
+        :return: mapping of gate labels to their fanouts.
+
+        """
+        return self._cached(
+            'fanouts',
+            lambda: {
+                label: len(self._gate_to_users.get(label, ())) for label in self._gates
+            },
+        )
+
+    def get_structural_metrics(self, reconvergence: bool = False) -> StructuralMetrics:
+        """
+        Get gate counts by type, levels, depth, critical path, fanout histogram and
+        optionally reconvergence statistics, computed in one pass over the circuit.
+        Result is cached until the circuit is modified and should not be modified.
+
+        :param reconvergence: whether to count reconvergent gates, which makes the pass
+            superlinear on circuits with many fanout stems.
+        :return: structural metrics of the circuit.
+
+        """
+        return self._cached(
+            ('metrics', reconvergence),
+            lambda: compute_structural_metrics(self, reconvergence=reconvergence),
+        )
+
+    def _top_sort(self, inverse: bool) -> list[gate.Label]:
+        """:return: labels of gates in topological order (see `top_sort`)."""
         _predecessors_getter = (
             (lambda elem: len(elem.operands))
             if inverse
@@ -1147,13 +1214,23 @@ class Circuit(Function):
         if not queue:
             raise CircuitIsCyclicalError()
 
+        order: list[gate.Label] = []
         while queue:
             current_elem = self.get_gate(queue.pop())
             for successor in _successors_getter(current_elem):
                 indegree_map[successor] -= 1
                 if indegree_map[successor] == 0:
                     queue.append(successor)
-            yield current_elem
+            order.append(current_elem.label)
+        return order
+
+    def _gate_levels(self) -> dict[gate.Label, int]:
+        levels: dict[gate.Label, int] = {}
+        for _gate in self.top_sort(inverse=True):
+            levels[_gate.label] = max(
+                (levels[operand] + 1 for operand in _gate.operands), default=0
+            )
+        return levels
 
     def dfs(
         self,
@@ -1355,6 +1432,17 @@ class Circuit(Function):
         answer = self.evaluate_circuit_outputs(dict_inputs)
         return tp.cast(list[bool], [answer[output] for output in self._outputs])
 
+    def compile(self) -> CompiledCircuit:
+        """
+        Compiles the circuit into an evaluator, which is much faster than `evaluate` on
+        many inputs. Evaluator doesn't follow modifications made after it was created,
+        and is not kept by the circuit, so it should be reused by the caller.
+
+        :return: evaluator of the current state of the circuit.
+
+        """
+        return CompiledCircuit(self)
+
     def evaluate_at(self, inputs: tp.Sequence[bool], output_index: int) -> bool:
         """
         Get value of `output_index`th output that corresponds to provided `inputs`.
@@ -1619,17 +1707,42 @@ class Circuit(Function):
         is a binary encoding of a number `j` (for example j=9 corresponds to [..., 1, 0,
         0, 1])
 
+        Circuit is simulated on many inputs at once. The result is not cached, since it
+        takes `2 ** input_size` bits per output.
+
         :return: truth table describing this function.
 
         """
+        width = 1 << self.input_size
         return [
-            list(i)
-            for i in zip(
-                *(
-                    self.evaluate(list(x))
-                    for x in itertools.product((False, True), repeat=self.input_size)
-                )
+            [bit == '1' for bit in reversed(format(vector, f'0{width}b'))]
+            for vector in self._packed_truth_table()
+        ]
+
+    def _packed_truth_table(self) -> list[int]:
+        """
+        :return: truth tables of outputs packed into integers, bit `j` of which is the
+            value on the input which is a binary encoding of `j`.
+
+        """
+        # Imported here, since simulation module depends on this one.
+        from cirbo.core.circuit.simulation import compile_bit_program, simulate_block
+
+        program = compile_bit_program(self)
+        block_inputs = min(self.input_size, _TRUTH_TABLE_BLOCK_INPUTS)
+        blocks = [
+            simulate_block(program, block_inputs, block)
+            for block in range(1 << (self.input_size - block_inputs))
+        ]
+        if len(blocks) == 1:
+            return blocks[0]
+        block_bytes = (1 << block_inputs) // 8
+        return [
+            int.from_bytes(
+                b''.join(block[i].to_bytes(block_bytes, 'little') for block in blocks),
+                'little',
             )
+            for i in range(self.output_size)
         ]
 
     def get_gates_truth_table(self) -> tp.Dict[gate.Label, list[GateState]]:
@@ -1661,6 +1774,7 @@ class Circuit(Function):
         old_gates = copy.copy(self.gates)
         for cur_gate in old_gates.values():
             convert_gate(cur_gate, self)
+        self._mark_modified()
         return self
 
     def into_graphviz_digraph(
@@ -1984,6 +2098,7 @@ class Circuit(Function):
             del self._gate_to_users[gate_label]
 
         del self._gates[gate_label]
+        self._mark_modified()
 
         if cur_gate.gate_type == gate.INPUT:
             self._inputs.remove(gate_label)
@@ -2035,6 +2150,7 @@ class Circuit(Function):
         self._gates[new_gate.label] = new_gate
         if new_gate.gate_type == gate.INPUT:
             self._inputs.append(new_gate.label)
+        self._mark_modified()
 
         return self
 
@@ -2061,6 +2177,7 @@ class Circuit(Function):
         self._gates[label] = gate.Gate(label, gate_type, operands, **kwargs)
         if gate_type == gate.INPUT:
             self._inputs.append(label)
+        self._mark_modified()
 
         return self
 
@@ -2071,6 +2188,7 @@ class Circuit(Function):
             and user in self._gate_to_users[gate_label]
         ):
             self._gate_to_users[gate_label].remove(user)
+            self._mark_modified()
 
     def _add_user(self, gate_label: gate.Label, user: gate.Label):
         """Add user for `gate`."""
@@ -2078,6 +2196,35 @@ class Circuit(Function):
             self._gate_to_users[gate_label] = [user]
         else:
             self._gate_to_users[gate_label].append(user)
+        self._mark_modified()
+
+    def _mark_modified(self) -> None:
+        """Increment modification counter and drop data derived from the circuit."""
+        self._version += 1
+        if self._cache:
+            self._cache.clear()
+
+    def __getstate__(self) -> dict[str, tp.Any]:
+        # Used by both pickle and `copy.deepcopy`: derived data is not copied, and is
+        # recomputed by the copy when needed.
+        state = self.__dict__.copy()
+        state['_cache'] = {}
+        return state
+
+    def __setstate__(self, state: dict[str, tp.Any]) -> None:
+        self.__dict__.update(state)
+        self._cache = {}
+
+    def _cached(self, key: tp.Hashable, compute: tp.Callable[[], tp.Any]) -> tp.Any:
+        """
+        :param key: key of the derived data.
+        :param compute: function computing the data.
+        :return: data computed for the current version of the circuit.
+
+        """
+        if key not in self._cache:
+            self._cache[key] = compute()
+        return self._cache[key]
 
     def _traverse_circuit(
         self,
@@ -0,0 +1,152 @@
+"""
+Module contains compilation of a circuit into a straight-line program, which evaluates
+all gates of the circuit one after another on vectors of values, without walking the
+circuit structure. The same program evaluates either one assignment or many of them
+packed into bits of integers.
+
+Program is run by a register machine of `mockturtle_wrapper` extension, which is
+compiled together with the package, so no compiler is needed at runtime. When package
+is built without extensions, program is run by bit-parallel simulation in Python.
+
+"""
+
+import typing as tp
+
+# Package can be used without compiled extensions,
+# then programs are run by simulation in Python.
+try:
+    from mockturtle_wrapper import BitProgram as _NativeProgram
+except ImportError:
+    _NativeProgram = None
+
+if tp.TYPE_CHECKING:
+    from cirbo.core.circuit.circuit import Circuit
+    from cirbo.core.circuit.gate import Label
+
+__all__ = ['CompiledCircuit', 'compile_native_program']
+
+
+class CompiledCircuit:
+    """
+    Evaluator of a fixed circuit. Cone of the outputs is lowered once to an array of
+    opcodes and positions of operands, and each evaluation runs this array on 64-bit
+    words of packed assignments in native code, with GIL released.
+
+    Evaluator doesn't follow further modifications of the circuit.
+
+    """
+
+    def __init__(self, circuit: 'Circuit'):
+        # Imported here, since simulation module depends on circuit module.
+        from cirbo.core.circuit.simulation import compile_bit_program
+
+        self._input_size = circuit.input_size
+        self._output_size = circuit.output_size
+        self._native = compile_native_program(circuit)
+        if self._native is None:
+            self._program = compile_bit_program(circuit)
+
+    @property
+    def input_size(self) -> int:
+        return self._input_size
+
+    @property
+    def output_size(self) -> int:
+        return self._output_size
+
+    def evaluate(self, inputs: tp.Sequence[bool]) -> list[bool]:
+        """
+        :param inputs: values of inputs.
+        :return: values of outputs.
+
+        """
+        self._check_input_size(len(inputs))
+        if self._native is not None:
+            return self._native.evaluate([bool(x) for x in inputs])
+        return [bool(value) for value in self._run([int(x) for x in inputs], 1)]
+
+    def evaluate_batch(
+        self,
+        assignments: tp.Iterable[tp.Sequence[bool]],
+    ) -> list[list[bool]]:
+        """
+        Evaluates circuit on many assignments at once, each of them occupying one bit
+        of the vectors of values.
+
+        :param assignments: values of inputs.
+        :return: values of outputs on each of the assignments.
+
+        """
+        assignments = list(assignments)
+        for assignment in assignments:
+            self._check_input_size(len(assignment))
+        size = len(assignments)
+        if size == 0:
+            return []
+
+        # Assignment `k` goes to bit `k`, so the first one is the last digit.
+        vectors = [
+            int(''.join('1' if x[i] else '0' for x in reversed(assignments)), 2)
+            for i in range(self._input_size)
+        ]
+        outputs = [
+            format(vector, f'0{size}b')[::-1]
+            for vector in self.evaluate_packed(vectors, size)
+        ]
+        return [[output[k] == '1' for output in outputs] for k in range(size)]
+
+    def evaluate_packed(self, inputs: tp.Sequence[int], size: int) -> list[int]:
+        """
+        :param inputs: vectors of values of inputs, bit `k` of which is the value in
+            `k`th assignment.
+        :param size: number of assignments.
+        :return: vectors of values of outputs in the same assignments, without bits
+            after `size`.
+
+        """
+        self._check_input_size(len(inputs))
+        mask = (1 << size) - 1
+        if self._native is not None:
+            length = (size + 7) // 8
+            outputs = self._native.evaluate_packed(
+                [(vector & mask).to_bytes(length, 'little') for vector in inputs],
+                size,
+            )
+            return [int.from_bytes(output, 'little') for output in outputs]
+        return self._run([vector & mask for vector in inputs], mask)
+
+    def _run(self, inputs: list[int], mask: int) -> list[int]:
+        # Imported here, since simulation module depends on circuit module.
+        from cirbo.core.circuit.simulation import run_bit_program
+
+        return run_bit_program(self._program, inputs, mask)
+
+    def _check_input_size(self, size: int) -> None:
+        if size != self._input_size:
+            raise ValueError(
+                f"Expected values of {self._input_size} inputs, got {size}."
+            )
+
+
+def compile_native_program(
+    circuit: 'Circuit',
+    output_labels: tp.Optional[list['Label']] = None,
+) -> tp.Optional[tp.Any]:
+    """
+    :param circuit: circuit to be compiled.
+    :param output_labels: labels of gates to be computed, outputs by default.
+    :return: `BitProgram` of `mockturtle_wrapper` computing the given gates, or None
+        if package is built without extensions.
+
+    """
+    # Imported here, since simulation module depends on circuit module.
+    from cirbo.core.circuit.simulation import lower_circuit
+
+    if _NativeProgram is None:
+        return None
+    gates, outputs = lower_circuit(circuit, output_labels)
+    return _NativeProgram(
+        circuit.input_size,
+        [(gate_type.name, list(operands)) for gate_type, operands in gates],
+        outputs,
+    )
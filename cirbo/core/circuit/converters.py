@@ -23,6 +23,7 @@ def convert_gate(_gate: gate.Gate, circuit: 'Circuit') -> None:
     """
     if _gate.gate_type in _convertors:
         _convertors[_gate.gate_type](_gate, circuit)
+        circuit._mark_modified()
 
 
 def _convert_lt(_gate: gate.Gate, circuit: 'Circuit') -> None:
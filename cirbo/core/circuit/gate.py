@@ -80,6 +80,8 @@ class GateType:
         return self._is_symmetric
 
     def __eq__(self, rhs):
+        if self is rhs:
+            return True
         if not isinstance(rhs, GateType):
             return NotImplemented
 
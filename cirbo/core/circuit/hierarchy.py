@@ -0,0 +1,293 @@
+"""
+Module contains hierarchical circuits, which consist of gates and instances of other
+circuits. Each instance references a shared definition instead of copying it, so a
+design built of many identical parts stores each part once. Hierarchical circuit can
+be simulated as is, and flattened into an ordinary `Circuit` on demand.
+
+"""
+
+import typing as tp
+
+from cirbo.core.circuit.circuit import Circuit
+from cirbo.core.circuit.exceptions import CircuitValidationError
+from cirbo.core.circuit.gate import Gate, GateType, INPUT, Label
+from cirbo.core.circuit.simulation import (
+    bit_operator,
+    BitProgram,
+    compile_bit_program,
+    lane_inputs,
+    run_bit_program,
+)
+
+__all__ = ['HierarchicalCircuit', 'Instance']
+
+
+class Instance(tp.NamedTuple):
+    """
+    Instance of a circuit inside a hierarchical circuit.
+
+    :param name: name of the instance.
+    :param definition: instantiated circuit, which is shared by all its instances and
+        must not be modified while it's used.
+    :param inputs: signals of the hierarchical circuit connected to inputs of the
+        definition.
+    :param outputs: signals of the hierarchical circuit, which carry values of outputs
+        of the definition.
+    :param version: version of the definition at the moment of instantiation.
+
+    """
+
+    name: Label
+    definition: Circuit
+    inputs: tuple[Label, ...]
+    outputs: tuple[Label, ...]
+    version: int
+
+    def check_definition(self) -> None:
+        """Checks that the definition wasn't modified after instantiation."""
+        if self.definition.version != self.version:
+            raise CircuitValidationError(
+                f'Definition of instance {self.name} was modified'
+            )
+
+
+class HierarchicalCircuit:
+    """
+    Circuit consisting of inputs, gates and instances of other circuits, each of which
+    is added after the signals it depends on. Outputs of instance `name` are named
+    `name@<output label in definition>`, which are the labels they get when the circuit
+    is flattened.
+
+    """
+
+    def __init__(self):
+        self._inputs: list[Label] = []
+        self._outputs: list[Label] = []
+        # Gates and instances in order of addition, which is a topological order.
+        self._nodes: dict[Label, tp.Union[Gate, Instance]] = {}
+        self._signals: set[Label] = set()
+        self._programs: dict[int, BitProgram] = {}
+
+    @property
+    def inputs(self) -> list[Label]:
+        return self._inputs
+
+    @property
+    def input_size(self) -> int:
+        return len(self._inputs)
+
+    @property
+    def outputs(self) -> list[Label]:
+        return self._outputs
+
+    @property
+    def output_size(self) -> int:
+        return len(self._outputs)
+
+    @property
+    def nodes(self) -> list[tp.Union[Gate, 'Instance']]:
+        """
+        :return: gates and instances in order of addition, which is topological.
+
+        """
+        return list(self._nodes.values())
+
+    @property
+    def gates(self) -> list[Gate]:
+        """
+        :return: gates of the circuit, except for inputs and gates of instances.
+
+        """
+        return [node for node in self._nodes.values() if isinstance(node, Gate)]
+
+    @property
+    def instances(self) -> list[Instance]:
+        return [node for node in self._nodes.values() if isinstance(node, Instance)]
+
+    @property
+    def size(self) -> int:
+        """
+        :return: number of gates of the flattened circuit.
+
+        """
+        return self.input_size + sum(
+            1 if isinstance(node, Gate) else _instance_size(node)
+            for node in self._nodes.values()
+        )
+
+    def has_signal(self, label: Label) -> bool:
+        return label in self._signals
+
+    def add_inputs(self, labels: tp.Iterable[Label]) -> None:
+        for label in labels:
+            self._check_new_name(label)
+            self._inputs.append(label)
+            self._signals.add(label)
+
+    def emplace_gate(
+        self,
+        label: Label,
+        gate_type: GateType,
+        operands: tuple[Label, ...] = (),
+    ) -> None:
+        """
+        Adds gate, operands of which are existing signals.
+
+        :param label: label of the gate.
+        :param gate_type: type of the gate.
+        :param operands: operands of the gate.
+
+        """
+        if gate_type == INPUT:
+            raise CircuitValidationError("Inputs should be added by add_inputs.")
+        self._check_new_name(label)
+        self._check_signals_exist(operands)
+        self._nodes[label] = Gate(label, gate_type, operands)
+        self._signals.add(label)
+
+    def add_instance(
+        self,
+        name: Label,
+        definition: Circuit,
+        inputs: tp.Sequence[Label],
+    ) -> list[Label]:
+        """
+        Adds instance of a circuit.
+
+        :param name: name of the instance.
+        :param definition: circuit to be instantiated. It's not copied, so it must not
+            be modified while this hierarchical circuit is used.
+        :param inputs: existing signals connected to inputs of the definition.
+        :return: signals carrying values of outputs of the definition.
+
+        """
+        self._check_new_name(name)
+        if len(inputs) != definition.input_size:
+            raise CircuitValidationError(
+                f'Instance {name} requires {definition.input_size} inputs'
+            )
+        self._check_signals_exist(inputs)
+
+        port = dict(zip(definition.inputs, inputs))
+        outputs = tuple(
+            port.get(output, f'{name}@{output}') for output in definition.outputs
+        )
+        connected = set(inputs)
+        new_signals = {output for output in outputs if output not in connected}
+        for label in new_signals:
+            self._check_new_name(label)
+
+        self._nodes[name] = Instance(
+            name=name,
+            definition=definition,
+            inputs=tuple(inputs),
+            outputs=outputs,
+            version=definition.version,
+        )
+        self._signals.update(new_signals)
+        return list(outputs)
+
+    def mark_as_output(self, label: Label) -> None:
+        self._check_signals_exist((label,))
+        self._outputs.append(label)
+
+    def set_outputs(self, labels: tp.Sequence[Label]) -> None:
+        self._check_signals_exist(labels)
+        self._outputs = list(labels)
+
+    def flatten(self) -> Circuit:
+        """
+        :return: ordinary circuit with gates of each instance copied into a block named
+            after the instance.
+
+        """
+        circuit = Circuit()
+        circuit.add_inputs(self._inputs)
+        for node in self._nodes.values():
+            if isinstance(node, Gate):
+                circuit.emplace_gate(node.label, node.gate_type, node.operands)
+                continue
+            node.check_definition()
+            circuit.connect_circuit(
+                node.definition,
+                list(node.inputs),
+                node.definition.inputs,
+                name=node.name,
+            )
+            # Outputs of the definition are appended to outputs by connect_circuit.
+            circuit.set_outputs([])
+        circuit.set_outputs(self._outputs)
+        return circuit
+
+    def simulate(self, inputs: tp.Sequence[int], mask: int) -> list[int]:
+        """
+        Simulates circuit on many assignments at once, each of them occupying one bit
+        of vectors of values. Each definition is compiled once and shared by its
+        instances.
+
+        :param inputs: vectors of values of inputs.
+        :param mask: vector of ones of the same length.
+        :return: vectors of values of outputs.
+
+        """
+        if len(inputs) != self.input_size:
+            raise ValueError(f"Expected values of {self.input_size} inputs.")
+        values: dict[Label, int] = dict(zip(self._inputs, inputs))
+        for node in self._nodes.values():
+            if isinstance(node, Gate):
+                values[node.label] = bit_operator(node.gate_type)(
+                    mask, *(values[operand] for operand in node.operands)
+                )
+                continue
+            program = self._program(node)
+            results = run_bit_program(
+                program, [values[label] for label in node.inputs], mask
+            )
+            values.update(zip(node.outputs, results))
+        return [values[label] for label in self._outputs]
+
+    def evaluate(self, inputs: tp.Sequence[bool]) -> list[bool]:
+        """
+        :param inputs: values of inputs.
+        :return: values of outputs.
+
+        """
+        return [bool(value) for value in self.simulate([int(x) for x in inputs], 1)]
+
+    def get_truth_table(self) -> list[list[bool]]:
+        """
+        :return: truth table, `i`th row of which contains values of `i`th output, and
+            `j`th column corresponds to the input which is a binary encoding of `j`.
+
+        """
+        width = 1 << self.input_size
+        vectors = self.simulate(lane_inputs(self.input_size), (1 << width) - 1)
+        return [
+            [bit == '1' for bit in reversed(format(vector, f'0{width}b'))]
+            for vector in vectors
+        ]
+
+    def _program(self, instance: Instance) -> BitProgram:
+        instance.check_definition()
+        # Instances keep their definitions alive, so ids are not reused.
+        key = id(instance.definition)
+        if key not in self._programs:
+            self._programs[key] = compile_bit_program(instance.definition)
+        return self._programs[key]
+
+    def _check_new_name(self, label: Label) -> None:
+        # Signals and names of instances share one namespace, since both are keys of
+        # nodes (and blocks of the flattened circuit are named after instances).
+        if label in self._signals or label in self._nodes:
+            raise CircuitValidationError(f'Name {label} exists in the circuit')
+
+    def _check_signals_exist(self, labels: tp.Iterable[Label]) -> None:
+        for label in labels:
+            if label not in self._signals:
+                raise CircuitValidationError(
+                    f'Gate {label} are not initialized in the circuit'
+                )
+
+
+def _instance_size(instance: Instance) -> int:
+    return instance.definition.size - instance.definition.input_size
@@ -0,0 +1,166 @@
+"""
+Module contains structural metrics of circuits (gate counts, levels, depth, fanouts,
+reconvergence), all of which are computed in one pass over the circuit in topological
+order. The pass is linear unless reconvergence is requested, which takes time
+proportional to the number of gates times the number of fanout stems divided by the
+word size.
+
+"""
+
+import collections
+import dataclasses
+import typing as tp
+
+from cirbo.core.circuit.gate import (
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+    GateType,
+    IFF,
+    INPUT,
+    Label,
+    LIFF,
+    LNOT,
+    NOT,
+    RIFF,
+    RNOT,
+)
+
+if tp.TYPE_CHECKING:
+    from cirbo.core.circuit.circuit import Circuit
+
+__all__ = [
+    'FREE_GATE_TYPES',
+    'StructuralMetrics',
+    'compute_structural_metrics',
+]
+
+
+# Gates which are not counted by `Circuit.gates_number` by default, and don't add to
+# the length of the critical path.
+FREE_GATE_TYPES: tuple[GateType, ...] = (
+    INPUT,
+    NOT,
+    LNOT,
+    RNOT,
+    IFF,
+    LIFF,
+    RIFF,
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+)
+
+
+@dataclasses.dataclass(frozen=True)
+class StructuralMetrics:
+    """
+    Structural metrics of a circuit.
+
+    :param gate_counts: number of gates of each type, including inputs.
+    :param levels: level of each gate, which is the number of gates (except for
+        inputs) on the longest path from an input or a constant to it.
+    :param depth: maximum level of an output.
+    :param critical_path: labels of gates on a path ending in an output, which has the
+        maximum number of gates not in `FREE_GATE_TYPES`.
+    :param critical_path_length: number of gates not in `FREE_GATE_TYPES` on the
+        critical path.
+    :param fanout_histogram: number of gates with each fanout, where fanout is the
+        number of occurrences of a gate as an operand.
+    :param fanout_stems: number of gates with fanout at least two.
+    :param reconvergent_gates: number of gates at which two paths from the same fanout
+        stem meet, or None if reconvergence was not requested.
+
+    """
+
+    gate_counts: dict[GateType, int]
+    levels: dict[Label, int]
+    depth: int
+    critical_path: list[Label]
+    critical_path_length: int
+    fanout_histogram: dict[int, int]
+    fanout_stems: int
+    reconvergent_gates: tp.Optional[int]
+
+
+def compute_structural_metrics(
+    circuit: 'Circuit',
+    *,
+    reconvergence: bool = False,
+) -> StructuralMetrics:
+    """
+    Computes structural metrics of a circuit in one pass in topological order. Use
+    `Circuit.get_structural_metrics` to get metrics cached until the circuit is
+    modified.
+
+    Note: reconvergence is found exactly by uniting sets of fanout stems in the fanin
+    of each gate, which are bit masks with one bit per stem. So with `reconvergence`
+    the pass takes O(gates * stems / word size) time rather than linear time on
+    circuits with many stems.
+
+    :param circuit: circuit to be analysed.
+    :param reconvergence: whether to count reconvergent gates.
+    :return: metrics of the circuit.
+
+    """
+    fanouts = circuit.get_fanout_counts()
+    gate_counts: collections.Counter[GateType] = collections.Counter()
+    levels: dict[Label, int] = {}
+    # Length of the critical path ending in a gate and the previous gate on it.
+    weights: dict[Label, int] = {}
+    previous: dict[Label, tp.Optional[Label]] = {}
+
+    # Sets of fanout stems in the fanin of gates, as bit masks. Mask of a gate is
+    # dropped once all its users are processed, so only the frontier is stored.
+    stems: dict[Label, int] = {}
+    number_of_stems = 0
+    remaining_users = dict(fanouts)
+    reconvergent_gates = 0
+
+    for _gate in circuit.top_sort(inverse=True):
+        label = _gate.label
+        gate_counts[_gate.gate_type] += 1
+
+        level = 0
+        weight = 0
+        heaviest: tp.Optional[Label] = None
+        union = 0
+        reconvergent = False
+        for operand in _gate.operands:
+            level = max(level, levels[operand] + 1)
+            if heaviest is None or weights[operand] > weight:
+                weight, heaviest = weights[operand], operand
+            if not reconvergence:
+                continue
+            mask = stems[operand]
+            reconvergent = reconvergent or bool(union & mask)
+            union |= mask
+            remaining_users[operand] -= 1
+            if remaining_users[operand] == 0:
+                del stems[operand]
+
+        levels[label] = level
+        weights[label] = weight + (_gate.gate_type not in FREE_GATE_TYPES)
+        previous[label] = heaviest
+        reconvergent_gates += reconvergent
+        if reconvergence and fanouts[label] > 0:
+            if fanouts[label] >= 2:
+                union |= 1 << number_of_stems
+            stems[label] = union
+        number_of_stems += fanouts[label] >= 2
+
+    end = max(circuit.outputs, key=weights.__getitem__, default=None)
+    critical_path: list[Label] = []
+    while end is not None:
+        critical_path.append(end)
+        end = previous[end]
+    critical_path.reverse()
+
+    return StructuralMetrics(
+        gate_counts=dict(gate_counts),
+        levels=levels,
+        depth=max((levels[output] for output in circuit.outputs), default=0),
+        critical_path=critical_path,
+        critical_path_length=weights[critical_path[-1]] if critical_path else 0,
+        fanout_histogram=dict(collections.Counter(fanouts.values())),
+        fanout_stems=number_of_stems,
+        reconvergent_gates=reconvergent_gates if reconvergence else None,
+    )
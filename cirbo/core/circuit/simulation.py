@@ -0,0 +1,316 @@
+"""
+Module contains bit-parallel simulation of circuits: values of a gate on many input
+assignments are packed into bits of one (arbitrary long) integer, so each gate is
+evaluated on all of them by a single bitwise operation.
+
+"""
+
+import functools
+import operator
+import typing as tp
+
+from cirbo.core.circuit.circuit import Circuit
+from cirbo.core.circuit.gate import (
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+    AND,
+    GateType,
+    GEQ,
+    GT,
+    IFF,
+    INPUT,
+    Label,
+    LEQ,
+    LIFF,
+    LNOT,
+    LT,
+    NAND,
+    NOR,
+    NOT,
+    NXOR,
+    OR,
+    RIFF,
+    RNOT,
+    XOR,
+)
+
+
+__all__ = [
+    'BitProgram',
+    'bit_operator',
+    'compile_bit_program',
+    'lane_inputs',
+    'lower_circuit',
+    'popcount',
+    'run_bit_program',
+    'simulate_block',
+]
+
+
+# Gate evaluation on bit vectors: receives the all-ones mask and operand vectors.
+BitOperator = tp.Callable[..., int]
+
+
+class BitProgram(tp.NamedTuple):
+    """
+    Circuit compiled for bit-parallel simulation.
+
+    :param input_size: number of inputs of the circuit.
+    :param instructions: pairs of an operator and positions of its operands in the
+        vector of values, where first values are inputs and each instruction appends
+        its result.
+    :param outputs: positions of values of the outputs.
+
+    """
+
+    input_size: int
+    instructions: list[tuple[BitOperator, tuple[int, ...]]]
+    outputs: list[int]
+
+
+def compile_bit_program(
+    circuit: Circuit,
+    output_labels: tp.Optional[list[Label]] = None,
+) -> BitProgram:
+    """
+    Compiles cone of the given outputs for bit-parallel simulation. The result
+    consists of plain tuples and module-level functions, so it can be sent to other
+    processes.
+
+    :param circuit: circuit to be compiled.
+    :param output_labels: labels of gates to be simulated, outputs by default.
+    :return: compiled program.
+
+    """
+    gates, outputs = lower_circuit(circuit, output_labels)
+    return BitProgram(
+        input_size=circuit.input_size,
+        instructions=[
+            (_BIT_OPERATORS[gate_type], operands) for gate_type, operands in gates
+        ],
+        outputs=outputs,
+    )
+
+
+def lower_circuit(
+    circuit: Circuit,
+    output_labels: tp.Optional[list[Label]] = None,
+) -> tuple[list[tuple[GateType, tuple[int, ...]]], list[int]]:
+    """
+    Lowers cone of the given outputs to a straight-line program over a vector of
+    values, where first values are inputs and each gate appends its result.
+
+    :param circuit: circuit to be lowered.
+    :param output_labels: labels of gates to be computed, outputs by default.
+    :return: gates of the cone in topological order, given by their types and
+        positions of operands, and positions of values of the outputs.
+
+    """
+    if output_labels is None:
+        output_labels = circuit.outputs
+    cone: set[Label] = set()
+    stack = list(output_labels)
+    while stack:
+        label = stack.pop()
+        if label not in cone:
+            cone.add(label)
+            stack.extend(circuit.get_gate(label).operands)
+
+    positions = {label: i for i, label in enumerate(circuit.inputs)}
+    gates = []
+    for _gate in circuit.top_sort(inverse=True):
+        if _gate.gate_type == INPUT or _gate.label not in cone:
+            continue
+        operands = tuple(positions[operand] for operand in _gate.operands)
+        gates.append((_gate.gate_type, operands))
+        positions[_gate.label] = len(positions)
+    return gates, [positions[label] for label in output_labels]
+
+
+@functools.lru_cache(maxsize=None)
+def lane_inputs(block_inputs: int) -> tuple[int, ...]:
+    """
+    :param block_inputs: number of inputs varying along bits of a vector.
+    :return: vectors of `2 ** block_inputs` bits, where bit `b` of vector `m` is the
+        value of `m`th of these inputs in the assignment, which is a big-endian
+        binary encoding of `b` (so the first input is the most significant bit).
+
+    """
+    width = 1 << block_inputs
+    if width < 8:
+        return tuple(
+            sum(1 << b for b in range(width) if (b >> j) & 1)
+            for j in reversed(range(block_inputs))
+        )
+    # Vectors are built from repeated byte patterns, since arithmetic on long
+    # integers (e.g. division) is slow.
+    result = []
+    for j in reversed(range(block_inputs)):
+        if j < 3:
+            pattern = _BYTE_PATTERNS[j]
+        else:
+            half = 1 << (j - 3)
+            pattern = b'\x00' * half + b'\xff' * half
+        result.append(int.from_bytes(pattern * (width // 8 // len(pattern)), 'little'))
+    return tuple(result)
+
+
+# Bytes, bit `b` of which is set iff bit `j` of `b` is set, for `j` = 0, 1, 2.
+_BYTE_PATTERNS = (b'\xaa', b'\xcc', b'\xf0')
+
+
+def simulate_block(program: BitProgram, block_inputs: int, block: int) -> list[int]:
+    """
+    Simulates circuit on `2 ** block_inputs` assignments at once: the first inputs
+    take values of big-endian binary encoding of `block`, and the last `block_inputs`
+    inputs go over all their assignments along bits of vectors. Thus bit `b` of the
+    vectors corresponds to the assignment with canonical index
+    `block * 2 ** block_inputs + b`.
+
+    :param program: compiled circuit.
+    :param block_inputs: number of inputs varying along bits of a vector.
+    :param block: values of the rest inputs.
+    :return: vectors of values of the outputs.
+
+    """
+    mask = (1 << (1 << block_inputs)) - 1
+    prefix_size = program.input_size - block_inputs
+    values = [
+        mask if (block >> (prefix_size - 1 - i)) & 1 else 0 for i in range(prefix_size)
+    ]
+    values.extend(lane_inputs(block_inputs))
+    return run_bit_program(program, values, mask)
+
+
+def run_bit_program(
+    program: BitProgram,
+    inputs: tp.Sequence[int],
+    mask: int,
+) -> list[int]:
+    """
+    :param program: compiled circuit.
+    :param inputs: vectors of values of inputs.
+    :param mask: vector of ones of the same length.
+    :return: vectors of values of the outputs.
+
+    """
+    values = list(inputs)
+    for bit_operator, operands in program.instructions:
+        values.append(bit_operator(mask, *(values[i] for i in operands)))
+    return [values[i] for i in program.outputs]
+
+
+def bit_operator(gate_type: GateType) -> BitOperator:
+    """
+    :param gate_type: type of a gate.
+    :return: function evaluating gate of this type on vectors, which receives the
+        all-ones mask and vectors of operands.
+
+    """
+    return _BIT_OPERATORS[gate_type]
+
+
+def popcount(value: int) -> int:
+    """
+    :param value: non-negative integer.
+    :return: number of ones in binary representation of `value`.
+
+    """
+    # `int.bit_count` is available since Python 3.10.
+    if hasattr(value, 'bit_count'):
+        return value.bit_count()
+    return bin(value).count('1')
+
+
+def _and(mask: int, *args: int) -> int:
+    return functools.reduce(operator.and_, args)
+
+
+def _nand(mask: int, *args: int) -> int:
+    return _and(mask, *args) ^ mask
+
+
+def _or(mask: int, *args: int) -> int:
+    return functools.reduce(operator.or_, args)
+
+
+def _nor(mask: int, *args: int) -> int:
+    return _or(mask, *args) ^ mask
+
+
+def _xor(mask: int, *args: int) -> int:
+    return functools.reduce(operator.xor, args)
+
+
+def _nxor(mask: int, *args: int) -> int:
+    return _xor(mask, *args) ^ mask
+
+
+def _not(mask: int, arg: int) -> int:
+    return arg ^ mask
+
+
+def _iff(mask: int, arg: int) -> int:
+    return arg
+
+
+def _always_true(mask: int, *args: int) -> int:
+    return mask
+
+
+def _always_false(mask: int, *args: int) -> int:
+    return 0
+
+
+def _lnot(mask: int, arg1: int, arg2: int) -> int:
+    return arg1 ^ mask
+
+
+def _rnot(mask: int, arg1: int, arg2: int) -> int:
+    return arg2 ^ mask
+
+
+def _liff(mask: int, arg1: int, arg2: int) -> int:
+    return arg1
+
+
+def _riff(mask: int, arg1: int, arg2: int) -> int:
+    return arg2
+
+
+def _gt(mask: int, arg1: int, arg2: int) -> int:
+    return arg1 & (arg2 ^ mask)
+
+
+def _lt(mask: int, arg1: int, arg2: int) -> int:
+    return (arg1 ^ mask) & arg2
+
+
+def _geq(mask: int, arg1: int, arg2: int) -> int:
+    return arg1 | (arg2 ^ mask)
+
+
+def _leq(mask: int, arg1: int, arg2: int) -> int:
+    return (arg1 ^ mask) | arg2
+
+
+_BIT_OPERATORS: dict[GateType, BitOperator] = {
+    ALWAYS_TRUE: _always_true,
+    ALWAYS_FALSE: _always_false,
+    AND: _and,
+    NAND: _nand,
+    OR: _or,
+    NOR: _nor,
+    XOR: _xor,
+    NXOR: _nxor,
+    NOT: _not,
+    IFF: _iff,
+    LNOT: _lnot,
+    RNOT: _rnot,
+    LIFF: _liff,
+    RIFF: _riff,
+    GT: _gt,
+    LT: _lt,
+    GEQ: _geq,
+    LEQ: _leq,
+}
@@ -10,6 +10,7 @@ __all__ = [
     'BadBooleanValue',
     'BadBooleanValue',
     'TruthTableBadShapeError',
+    'PackedTruthTableFormatError',
     'BadCallableError',
 ]
 
@@ -50,6 +51,12 @@ class TruthTableBadShapeError(BooleanModelError):
     pass
 
 
+class PackedTruthTableFormatError(BooleanFunctionError):
+    """Represents error raised when file is not a valid packed truth table."""
+
+    pass
+
+
 class BadCallableError(CirboError):
     """Represents error raised provided unsupported callable to PyFunction."""
 
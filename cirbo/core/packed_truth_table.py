@@ -0,0 +1,505 @@
+"""
+Module defines packed truth table file format, which stores one bit per input
+assignment, and a boolean function backed by such a memory-mapped file. Truth tables
+of functions with 30 and more inputs don't fit into memory as lists of bools, but
+take only `2 ** (n - 3)` bytes per output in this format, and are processed by
+chunks without loading the whole file.
+
+File layout: header of `_HEADER_SIZE` bytes (magic, format version, number of inputs
+and outputs), followed by a bit array of each output. Bit `j` of an output (bit
+`j % 8` of byte `j // 8`) is its value on the input with canonical index `j`, i.e.
+the first input is the most significant bit of `j`.
+
+"""
+
+import concurrent.futures
+import functools
+import itertools
+import mmap
+import os
+import struct
+import typing as tp
+
+from cirbo.core.boolean_function import Function, RawTruthTable
+from cirbo.core.circuit.circuit import Circuit
+from cirbo.core.circuit.simulation import (
+    BitProgram,
+    compile_bit_program,
+    lane_inputs,
+    popcount,
+    simulate_block,
+)
+from cirbo.core.exceptions import PackedTruthTableFormatError
+from cirbo.core.utils import canonical_index_to_input, input_to_canonical_index
+
+
+__all__ = [
+    'PackedTruthTable',
+    'write_packed_truth_table',
+]
+
+
+_MAGIC = b'CIRBOPTT'
+_VERSION = 1
+# Magic, version, number of inputs, number of outputs.
+_HEADER = struct.Struct('<8sIII')
+# Header is padded, so bit arrays are aligned.
+_HEADER_SIZE = 64
+
+# Number of inputs varying within one chunk, so chunk takes 2 ** 17 bytes.
+_CHUNK_INPUTS = 20
+
+
+def write_packed_truth_table(
+    function: Function,
+    path: tp.Union[str, os.PathLike],
+    *,
+    workers: int = 1,
+) -> None:
+    """
+    Writes truth table of a boolean function to a file in packed format.
+
+    Circuits are simulated bit-parallel by chunks of `2 ** 20` assignments, split by
+    values of the first inputs. Each chunk is written to its place in the file as soon
+    as it's computed, so memory consumption doesn't depend on the number of inputs.
+    Other functions are evaluated on each assignment one by one.
+
+    :param function: boolean function, e.g. Circuit.
+    :param path: path to the file to be written.
+    :param workers: number of processes simulating chunks of a circuit in parallel.
+
+    """
+    input_size, output_size = function.input_size, function.output_size
+    chunk_inputs = min(input_size, _CHUNK_INPUTS)
+    with open(path, 'wb') as file:
+        file.write(_HEADER.pack(_MAGIC, _VERSION, input_size, output_size))
+        file.truncate(_HEADER_SIZE + output_size * _table_bytes(input_size))
+
+    if not isinstance(function, Circuit):
+        _write_evaluated_chunks(function, path, chunk_inputs)
+        return
+
+    program = compile_bit_program(function)
+    chunks = 1 << (input_size - chunk_inputs)
+    parts = max(1, min(workers, chunks))
+    bounds = [chunks * i // parts for i in range(parts + 1)]
+    ranges = [range(bounds[i], bounds[i + 1]) for i in range(parts)]
+    task = functools.partial(_write_simulated_chunks, program, path, chunk_inputs)
+    if parts == 1:
+        task(ranges[0])
+        return
+    with concurrent.futures.ProcessPoolExecutor(max_workers=parts) as executor:
+        list(executor.map(task, ranges))
+
+
+def _table_bytes(input_size: int) -> int:
+    return max(1, (1 << input_size) // 8)
+
+
+def _write_simulated_chunks(
+    program: BitProgram,
+    path: tp.Union[str, os.PathLike],
+    chunk_inputs: int,
+    chunks: range,
+) -> None:
+    table_bytes = _table_bytes(program.input_size)
+    chunk_bytes = _table_bytes(chunk_inputs)
+    # Processes write disjoint parts of the file, which is already of full size.
+    with open(path, 'r+b') as file:
+        for chunk in chunks:
+            vectors = simulate_block(program, chunk_inputs, chunk)
+            for output_index, vector in enumerate(vectors):
+                file.seek(
+                    _HEADER_SIZE + output_index * table_bytes + chunk * chunk_bytes
+                )
+                file.write(vector.to_bytes(chunk_bytes, 'little'))
+
+
+def _write_evaluated_chunks(
+    function: Function,
+    path: tp.Union[str, os.PathLike],
+    chunk_inputs: int,
+) -> None:
+    input_size = function.input_size
+    table_bytes = _table_bytes(input_size)
+    chunk_bytes = _table_bytes(chunk_inputs)
+    with open(path, 'r+b') as file:
+        for chunk in range(1 << (input_size - chunk_inputs)):
+            vectors = [0] * function.output_size
+            for lane in range(1 << chunk_inputs):
+                index = (chunk << chunk_inputs) | lane
+                values = function.evaluate(
+                    canonical_index_to_input(index, input_size) if input_size else []
+                )
+                for output_index, value in enumerate(values):
+                    if value:
+                        vectors[output_index] |= 1 << lane
+            for output_index, vector in enumerate(vectors):
+                file.seek(
+                    _HEADER_SIZE + output_index * table_bytes + chunk * chunk_bytes
+                )
+                file.write(vector.to_bytes(chunk_bytes, 'little'))
+
+
+@functools.lru_cache(maxsize=64)
+def _weight_masks(chunk_inputs: int, negations: tuple[bool, ...]) -> tuple[int, ...]:
+    """
+    :return: vectors of chunk bits, `w`th of which selects assignments of the inputs
+        varying within a chunk with exactly `w` ones after applying negations.
+
+    """
+    mask = (1 << (1 << chunk_inputs)) - 1
+    masks = [mask] + [0] * chunk_inputs
+    for vector, negated in zip(lane_inputs(chunk_inputs), negations):
+        if negated:
+            vector ^= mask
+        for w in range(chunk_inputs, 0, -1):
+            masks[w] = (masks[w] & (vector ^ mask)) | (masks[w - 1] & vector)
+        masks[0] &= vector ^ mask
+    return tuple(masks)
+
+
+class PackedTruthTable(Function):
+    """
+    Boolean function given as a memory-mapped packed truth table file (see
+    `write_packed_truth_table`). Property checks read the file by chunks of
+    `2 ** 20` assignments and process each chunk by a few bitwise operations.
+
+    Should be closed by `close` or used as a context manager.
+
+    """
+
+    def __init__(self, path: tp.Union[str, os.PathLike]):
+        """
+        :param path: path to a packed truth table file.
+
+        """
+        self._file = open(path, 'rb')
+        try:
+            header = self._file.read(_HEADER.size)
+            if len(header) != _HEADER.size:
+                raise PackedTruthTableFormatError("File is too short.")
+            magic, version, input_size, output_size = _HEADER.unpack(header)
+            if magic != _MAGIC or version != _VERSION:
+                raise PackedTruthTableFormatError("Unknown file format.")
+            self._input_size: int = input_size
+            self._output_size: int = output_size
+            self._table_bytes = _table_bytes(input_size)
+            expected_size = _HEADER_SIZE + output_size * self._table_bytes
+            if os.fstat(self._file.fileno()).st_size != expected_size:
+                raise PackedTruthTableFormatError("File size doesn't match header.")
+            self._mmap = mmap.mmap(self._file.fileno(), 0, access=mmap.ACCESS_READ)
+        except BaseException:
+            self._file.close()
+            raise
+
+        self._chunk_inputs = min(input_size, _CHUNK_INPUTS)
+        self._chunk_bytes = _table_bytes(self._chunk_inputs)
+        self._chunks = 1 << (input_size - self._chunk_inputs)
+        self._mask = (1 << (1 << self._chunk_inputs)) - 1
+
+    def close(self) -> None:
+        """Unmaps and closes the file."""
+        if not self._mmap.closed:
+            self._mmap.close()
+        self._file.close()
+
+    def __enter__(self) -> 'PackedTruthTable':
+        return self
+
+    def __exit__(self, *_: tp.Any) -> None:
+        self.close()
+
+    @property
+    def input_size(self) -> int:
+        """
+        :return: number of inputs.
+        """
+        return self._input_size
+
+    @property
+    def output_size(self) -> int:
+        """
+        :return: number of outputs.
+        """
+        return self._output_size
+
+    def _chunk(self, output_index: int, chunk: int) -> int:
+        """
+        :return: vector of values of output on `chunk`th chunk of assignments.
+
+        """
+        start = (
+            _HEADER_SIZE + output_index * self._table_bytes + chunk * self._chunk_bytes
+        )
+        data = self._mmap[start : start + self._chunk_bytes]
+        return int.from_bytes(data, 'little') & self._mask
+
+    def evaluate(self, inputs: tp.Sequence[bool]) -> tp.Sequence[bool]:
+        """
+        Get output values that correspond to provided `inputs`.
+
+        :param inputs: values of input gates.
+        :return: value of outputs evaluated for input values `inputs`.
+
+        """
+        return [self.evaluate_at(inputs, i) for i in range(self.output_size)]
+
+    def evaluate_at(self, inputs: tp.Sequence[bool], output_index: int) -> bool:
+        """
+        Get value of `output_index`th output that corresponds to provided `inputs`.
+
+        :param inputs: values of input gates.
+        :param output_index: index of desired output.
+        :return: value of `output_index` evaluated for input values `inputs`.
+
+        """
+        idx = input_to_canonical_index(inputs) if self.input_size else 0
+        byte = self._mmap[_HEADER_SIZE + output_index * self._table_bytes + idx // 8]
+        return bool((byte >> (idx % 8)) & 1)
+
+    def is_constant(self) -> bool:
+        """
+        Check if all outputs are constant (input independent).
+
+        :return: True iff this function is constant.
+
+        """
+        return all(self.is_constant_at(i) for i in range(self.output_size))
+
+    def is_constant_at(self, output_index: int) -> bool:
+        """
+        Check if output `output_index` is constant (input independent).
+
+        :param output_index: index of desired output.
+        :return: True iff output `output_index` is constant.
+
+        """
+        expected = self._mask if self._chunk(output_index, 0) & 1 else 0
+        return all(
+            self._chunk(output_index, chunk) == expected
+            for chunk in range(self._chunks)
+        )
+
+    def is_monotone(self, inverse: bool = False) -> bool:
+        """
+        Check if all outputs are monotone (output value doesn't decrease when
+        inputs are enumerated in a classic order: 0000, 0001, 0010, 0011 ...).
+
+        :param inverse: if True, will check that output values doesn't
+        increase when inputs are enumerated in classic order.
+        :return: True iff this function is monotone.
+
+        """
+        return all(
+            self.is_monotone_at(i, inverse=inverse) for i in range(self.output_size)
+        )
+
+    def is_monotone_at(self, output_index: int, inverse: bool = False) -> bool:
+        """
+        Check if output `output_index` is monotone (output value doesn't
+        decrease when inputs are enumerated in a classic order: 0000, 0001,
+        0010, 0011 ...).
+
+        :param output_index: index of desired output.
+        :param inverse: if True, will check that output value doesn't
+        increase when inputs are enumerated in classic order.
+        :return: True iff output `output_index` is monotone.
+
+        """
+        ones_started = False
+        for chunk in range(self._chunks):
+            vector = self._chunk(output_index, chunk)
+            if inverse:
+                vector ^= self._mask
+            if ones_started:
+                if vector != self._mask:
+                    return False
+            elif vector:
+                # All bits starting from the lowest set one must be set.
+                lowest = vector & -vector
+                if vector != self._mask ^ (lowest - 1):
+                    return False
+                ones_started = True
+        return True
+
+    def is_symmetric(self) -> bool:
+        """
+        Check if all outputs are symmetric.
+
+        :return: True iff this function is symmetric.
+
+        """
+        return all(self.is_symmetric_at(i) for i in range(self.output_size))
+
+    def is_symmetric_at(self, output_index: int) -> bool:
+        """
+        Check that output `output_index` is symmetric.
+
+        :param output_index: index of desired output.
+        :return: True iff output `output_index` is symmetric.
+
+        """
+        return self._is_symmetric_with_negations(
+            output_index, (False,) * self.input_size
+        )
+
+    def _is_symmetric_with_negations(
+        self,
+        output_index: int,
+        negations: tuple[bool, ...],
+    ) -> bool:
+        prefix_size = self.input_size - self._chunk_inputs
+        prefix_negations = input_to_canonical_index(negations[:prefix_size] or [0])
+        weight_masks = _weight_masks(self._chunk_inputs, negations[prefix_size:])
+        # Value of the output on inputs with given number of ones.
+        values: dict[int, bool] = {}
+        for chunk in range(self._chunks):
+            vector = self._chunk(output_index, chunk)
+            prefix_weight = popcount(chunk ^ prefix_negations)
+            for weight, weight_mask in enumerate(weight_masks):
+                selected = vector & weight_mask
+                if selected == 0:
+                    value = False
+                elif selected == weight_mask:
+                    value = True
+                else:
+                    return False
+                if values.setdefault(prefix_weight + weight, value) != value:
+                    return False
+        return True
+
+    def is_dependent_on_input_at(self, output_index: int, input_index: int) -> bool:
+        """
+        Check if output `output_index` depends on input `input_index` (there exist two
+        input sets that differ only at `input_index`, but result in different value for
+        `output_index`).
+
+        :param output_index: index of desired output.
+        :param input_index: index of desired input.
+        :return: True iff output `output_index` depends on input `input_index`.
+
+        """
+        bit_index = self.input_size - 1 - input_index
+        if bit_index < self._chunk_inputs:
+            # Compare each assignment with the one having this input set.
+            lane = lane_inputs(self._chunk_inputs)[self._chunk_inputs - 1 - bit_index]
+            shift = 1 << bit_index
+            # Assignments where this input is not set.
+            unset = lane >> shift
+            return any(
+                ((vector >> shift) ^ vector) & unset
+                for vector in (
+                    self._chunk(output_index, chunk) for chunk in range(self._chunks)
+                )
+            )
+        flip = 1 << (bit_index - self._chunk_inputs)
+        return any(
+            self._chunk(output_index, chunk) != self._chunk(output_index, chunk | flip)
+            for chunk in range(self._chunks)
+            if not chunk & flip
+        )
+
+    def _input_vector(self, input_index: int, chunk: int) -> int:
+        """
+        :return: vector of values of input `input_index` on `chunk`th chunk.
+
+        """
+        bit_index = self.input_size - 1 - input_index
+        if bit_index < self._chunk_inputs:
+            return lane_inputs(self._chunk_inputs)[self._chunk_inputs - 1 - bit_index]
+        return self._mask if (chunk >> (bit_index - self._chunk_inputs)) & 1 else 0
+
+    def is_output_equal_to_input(
+        self,
+        output_index: int,
+        input_index: int,
+    ) -> bool:
+        """
+        Check if output `output_index` equals to input `input_index`.
+
+        :param output_index: index of desired output.
+        :param input_index: index of desired input.
+        :return: True iff output `output_index` equals to the input
+        `input_index`.
+
+        """
+        return all(
+            self._chunk(output_index, chunk) == self._input_vector(input_index, chunk)
+            for chunk in range(self._chunks)
+        )
+
+    def is_output_equal_to_input_negation(
+        self,
+        output_index: int,
+        input_index: int,
+    ) -> bool:
+        """
+        Check if output `output_index` equals to negation of input `input_index`.
+
+        :param output_index: index of desired output.
+        :param input_index: index of desired input.
+        :return: True iff output `output_index` equals to negation of input
+        `input_index`.
+
+        """
+        return all(
+            self._chunk(output_index, chunk)
+            == self._input_vector(input_index, chunk) ^ self._mask
+            for chunk in range(self._chunks)
+        )
+
+    def get_significant_inputs_of(self, output_index: int) -> list[int]:
+        """
+        Get indexes of all inputs on which output `output_index` depends on.
+
+        :param output_index: index of desired output.
+        :return: list of input indices.
+
+        """
+        return [
+            input_index
+            for input_index in range(self.input_size)
+            if self.is_dependent_on_input_at(output_index, input_index)
+        ]
+
+    def find_negations_to_make_symmetric(
+        self,
+        output_index: list[int],
+    ) -> tp.Optional[list[bool]]:
+        """
+        Check if exist input negations set such that function is symmetric on given
+        output set.
+
+        :param output_index: output index set
+        :return: set of negations if it exists, else `None`.
+
+        """
+        for negations in itertools.product((False, True), repeat=self.input_size):
+            if all(
+                self._is_symmetric_with_negations(i, negations) for i in output_index
+            ):
+                return list(negations)
+        return None
+
+    def get_truth_table(self) -> RawTruthTable:
+        """
+        Get truth table of a boolean function, which is a matrix, `i`th row of which
+        contains values of `i`th output, and `j`th column corresponds to the input which
+        is a binary encoding of a number `j` (for example j=9 corresponds to [..., 1, 0,
+        0, 1])
+
+        Note: the whole table is loaded into memory as lists of bools.
+
+        :return: truth table describing this function.
+
+        """
+        width = 1 << self._chunk_inputs
+        table: RawTruthTable = []
+        for output_index in range(self.output_size):
+            values: list[bool] = []
+            for chunk in range(self._chunks):
+                vector = self._chunk(output_index, chunk)
+                values.extend(bool((vector >> b) & 1) for b in range(width))
+            table.append(values)
+        return table
@@ -269,6 +269,7 @@ class BenchToCircuit(AbstractBenchParser):
         _gate = line[7:].strip(') \n')
         logger.debug(f'\tAdding output gate: {_gate}')
         self._circuit._outputs.append(_gate)
+        self._circuit._mark_modified()
         return []
 
     def _process_not(self, out: str, arg: str):
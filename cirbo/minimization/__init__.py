@@ -1,8 +1,21 @@
 """Subpackage containes plenty of circuit minimization algorithms including low effort
 simplification algorithms located in pacakge `simplification` and represented in as a
 composition in the method `cleanup` and subcircuit minimization algorithm defined by
-`minimize_subcircuits` method."""
+`minimize_subcircuits` method and simulation-driven resubstitution defined by
+`Resubstitution` transformer, native mockturtle algorithms defined by
+`MockturtleOptimization` transformer, and parallel optimization of large circuits by
+partitions defined by `PartitionedOptimization` transformer, and racing of several
+optimization scripts defined by `run_portfolio` method."""
 
+from .mockturtle_optimization import MockturtleAlgorithm, MockturtleOptimization
+from .partition import (
+    extract_partition,
+    Partition,
+    PartitionedOptimization,
+    partition_circuit,
+)
+from .portfolio import PortfolioCriterion, PortfolioResult, run_portfolio
+from .resubstitution import Resubstitution
 from .simplification import cleanup, MergeUnaryOperators, RemoveRedundantGates
 from .subcircuit import minimize_subcircuits
 
@@ -13,4 +26,18 @@ __all__ = [
     'cleanup',
     # subcircuit.py
     'minimize_subcircuits',
+    # resubstitution.py
+    'Resubstitution',
+    # mockturtle_optimization.py
+    'MockturtleAlgorithm',
+    'MockturtleOptimization',
+    # partition.py
+    'Partition',
+    'partition_circuit',
+    'extract_partition',
+    'PartitionedOptimization',
+    # portfolio.py
+    'PortfolioCriterion',
+    'PortfolioResult',
+    'run_portfolio',
 ]
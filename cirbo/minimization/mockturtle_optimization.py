@@ -0,0 +1,156 @@
+"""
+Module contains transformer which optimizes circuits by native mockturtle algorithms
+(cut rewriting, refactoring, resubstitution and balancing) without textual round trip
+through bench format.
+
+"""
+
+import enum
+import typing as tp
+
+import mockturtle_wrapper as mw
+
+from cirbo.core.circuit import ALWAYS_FALSE, AND, Circuit, Gate, INPUT, Label, NOT, XOR
+from cirbo.core.circuit.transformer import Transformer
+from cirbo.minimization.exception import UnsupportedOperationError
+from cirbo.synthesis.circuit_search import Basis, resolve_basis
+
+
+__all__ = [
+    'MockturtleAlgorithm',
+    'MockturtleOptimization',
+]
+
+
+class MockturtleAlgorithm(enum.Enum):
+    """Optimization algorithms of mockturtle."""
+
+    # Cut rewriting using database of optimal 4-input networks.
+    REWRITE = 'rewrite'
+    # Refactoring of fanout-free cones using SOP factoring.
+    REFACTOR = 'refactor'
+    # Simulation-guided resubstitution.
+    RESUB = 'resub'
+    # Depth-oriented SOP (AIG) or ESOP (XAIG) balancing.
+    BALANCE = 'balance'
+
+
+_DEFAULT_SCRIPT = (
+    MockturtleAlgorithm.REWRITE,
+    MockturtleAlgorithm.REFACTOR,
+    MockturtleAlgorithm.RESUB,
+)
+
+
+class MockturtleOptimization(Transformer):
+    """
+    Optimizes circuit by a sequence of mockturtle algorithms. Circuit is converted into
+    an in-memory XAG (for XAIG basis) or AIG (for AIG basis) network, optimized and
+    converted back, so XOR gates are kept only in the former case.
+
+    Resulting circuit consists of inputs, binary AND (and XOR) gates and NOT gates.
+    Labels of inputs are preserved, other gates get new labels.
+
+    Note: Python GIL is released while mockturtle runs, so several circuits can be
+    optimized concurrently in threads.
+
+    """
+
+    def __init__(
+        self,
+        script: tp.Sequence[tp.Union[str, MockturtleAlgorithm]] = _DEFAULT_SCRIPT,
+        basis: tp.Union[str, Basis] = Basis.XAIG,
+    ):
+        """
+        :param script: algorithms to run one after another.
+        :param basis: basis of the resulting circuit, either AIG or XAIG.
+
+        """
+        super().__init__()
+        self._script = tuple(MockturtleAlgorithm(algorithm) for algorithm in script)
+        self._basis = resolve_basis(basis)
+        if self._basis not in (Basis.AIG, Basis.XAIG):
+            raise UnsupportedOperationError(
+                f"Mockturtle optimization supports only AIG and XAIG bases, "
+                f"got {self._basis.name}."
+            )
+
+    def _transform(self, circuit: Circuit) -> Circuit:
+        """
+        :param circuit: the original circuit to be optimized.
+        :return: new optimized version of the circuit.
+
+        """
+        gates = [
+            (gate.label, gate.gate_type.name, list(gate.operands))
+            for gate in circuit.top_sort(inverse=True)
+            if gate.gate_type != INPUT
+        ]
+        inputs, network_gates, outputs = mw.optimize_network(
+            circuit.inputs,
+            gates,
+            circuit.outputs,
+            [algorithm.value for algorithm in self._script],
+            self._basis == Basis.XAIG,
+        )
+        return _NetworkBuilder(circuit.inputs).build(inputs, network_gates, outputs)
+
+    def __eq__(self, other: tp.Any):
+        if not isinstance(other, MockturtleOptimization):
+            return NotImplemented
+
+        return (
+            super().__eq__(other)
+            and self._script == other._script
+            and self._basis == other._basis
+        )
+
+
+class _NetworkBuilder:
+    """Builds circuit from a network returned by `mockturtle_wrapper`."""
+
+    def __init__(self, input_labels: list[Label]):
+        self._circuit = Circuit()
+        self._input_labels = input_labels
+        # Prefix of new labels, which can't be confused with labels of inputs.
+        self._prefix = 'mt_'
+        while any(str(label).startswith(self._prefix) for label in input_labels):
+            self._prefix = '_' + self._prefix
+        self._labels: dict[int, Label] = {}
+        self._negations: dict[int, Label] = {}
+
+    def build(
+        self,
+        inputs: list[int],
+        gates: list[tuple[int, str, list[tuple[int, bool]]]],
+        outputs: list[tuple[int, bool]],
+    ) -> Circuit:
+        for index, label in zip(inputs, self._input_labels):
+            self._circuit.add_gate(Gate(label, INPUT))
+            self._labels[index] = label
+
+        for index, gate_type, operands in gates:
+            label = f'{self._prefix}{index}'
+            self._circuit.emplace_gate(
+                label,
+                AND if gate_type == 'AND' else XOR,
+                tuple(self._signal(*operand) for operand in operands),
+            )
+            self._labels[index] = label
+
+        self._circuit.set_outputs([self._signal(*output) for output in outputs])
+        return self._circuit
+
+    def _signal(self, index: int, complemented: bool) -> Label:
+        if index not in self._labels:
+            # The only node which is not created explicitly is the constant false.
+            label = f'{self._prefix}{index}'
+            self._circuit.emplace_gate(label, ALWAYS_FALSE, ())
+            self._labels[index] = label
+        if not complemented:
+            return self._labels[index]
+        if index not in self._negations:
+            label = f'{self._prefix}{index}_not'
+            self._circuit.emplace_gate(label, NOT, (self._labels[index],))
+            self._negations[index] = label
+        return self._negations[index]
@@ -0,0 +1,308 @@
+"""
+Module contains partitioning of large circuits into bounded-size parts with explicit
+boundary signals, and a transformer which optimizes such parts in parallel and stitches
+them back together.
+
+"""
+
+import concurrent.futures
+import dataclasses
+import logging
+import os
+import typing as tp
+
+import pebble
+
+from cirbo.core.circuit import Circuit, Gate, INPUT, Label
+from cirbo.core.circuit.transformer import Transformer
+from cirbo.minimization.exception import FailedValidationError
+from cirbo.sat.miter import build_miter
+from cirbo.sat.sat import is_circuit_satisfiable, PySATSolverNames
+
+
+__all__ = [
+    'Partition',
+    'partition_circuit',
+    'extract_partition',
+    'PartitionedOptimization',
+]
+
+
+logger = logging.getLogger(__name__)
+
+
+Optimizer = tp.Union[Transformer, tp.Callable[[Circuit], Circuit]]
+
+
+@dataclasses.dataclass
+class Partition:
+    """
+    Part of a circuit.
+
+    :param gates: labels of partition gates in topological order.
+    :param inputs: labels of gates outside the partition used by its gates.
+    :param outputs: labels of partition gates used outside the partition or being
+        outputs of the circuit.
+
+    """
+
+    gates: list[Label]
+    inputs: list[Label]
+    outputs: list[Label]
+
+
+def _post_order(circuit: Circuit) -> list[Label]:
+    """
+    :return: labels of non-input gates reachable from circuit outputs in DFS post-order,
+        which keeps gates of the same cone close to each other.
+
+    """
+    order: list[Label] = []
+    visited: set[Label] = set()
+    for output in circuit.outputs:
+        if output in visited:
+            continue
+        visited.add(output)
+        stack: list[tuple[Label, int]] = [(output, 0)]
+        while stack:
+            label, position = stack.pop()
+            operands = circuit.get_gate(label).operands
+            if position < len(operands):
+                stack.append((label, position + 1))
+                operand = operands[position]
+                if operand not in visited:
+                    visited.add(operand)
+                    stack.append((operand, 0))
+            elif circuit.get_gate(label).gate_type != INPUT:
+                order.append(label)
+    return order
+
+
+def partition_circuit(circuit: Circuit, max_gates: int) -> list[Partition]:
+    """
+    Splits a circuit into partitions of at most `max_gates` gates each. Gates are
+    ordered by depth-first traversal from outputs and cut into consecutive chunks, so
+    partitions are listed in topological order: inputs of each partition are either
+    inputs of the circuit or outputs of preceding partitions.
+
+    Gates which don't affect circuit outputs are not included in any partition.
+
+    :param circuit: circuit to be partitioned.
+    :param max_gates: maximum number of gates in a single partition.
+    :return: list of partitions.
+
+    """
+    if max_gates < 1:
+        raise ValueError("Partition must contain at least one gate.")
+
+    order = _post_order(circuit)
+    circuit_outputs = set(circuit.outputs)
+    partitions: list[Partition] = []
+    for start in range(0, len(order), max_gates):
+        gates = order[start : start + max_gates]
+        members = set(gates)
+
+        inputs: list[Label] = []
+        for label in gates:
+            for operand in circuit.get_gate(label).operands:
+                if operand not in members and operand not in inputs:
+                    inputs.append(operand)
+
+        outputs = [
+            label
+            for label in gates
+            if label in circuit_outputs
+            or any(user not in members for user in circuit.get_gate_users(label))
+        ]
+        partitions.append(Partition(gates=gates, inputs=inputs, outputs=outputs))
+    return partitions
+
+
+def extract_partition(circuit: Circuit, partition: Partition) -> Circuit:
+    """
+    :return: standalone circuit of the partition, whose inputs and outputs are those of
+        the partition.
+
+    """
+    result = Circuit()
+    for label in partition.inputs:
+        result.add_gate(Gate(label, INPUT))
+    for label in partition.gates:
+        _gate = circuit.get_gate(label)
+        result.emplace_gate(label, _gate.gate_type, _gate.operands)
+    result.set_outputs(partition.outputs)
+    return result
+
+
+def _optimize(optimizer: Optimizer, circuit: Circuit) -> Circuit:
+    if isinstance(optimizer, Transformer):
+        return optimizer.transform(circuit)
+    return optimizer(circuit)
+
+
+class PartitionedOptimization(Transformer):
+    """
+    Optimizes large circuits part by part. Circuit is split into partitions of bounded
+    size (see `partition_circuit`), each partition is optimized independently in a
+    separate process, and the optimized partitions which became smaller replace the
+    original ones.
+
+    Optimizer may be any `Transformer` (e.g. `MockturtleOptimization`) or a function
+    taking and returning a circuit, for example `cleanup`,
+    `functools.partial(minimize_subcircuits, basis='XAIG')` or a function calling
+    `abc_transform`. It must preserve input labels and the order of outputs of the
+    circuit it is given, and must be picklable if several workers are used.
+
+    """
+
+    def __init__(
+        self,
+        optimizer: Optimizer,
+        *,
+        max_partition_size: int = 1000,
+        max_workers: tp.Optional[int] = None,
+        partition_time_limit: tp.Optional[float] = None,
+        check_equivalence: bool = False,
+        solver_name: tp.Union[PySATSolverNames, str] = PySATSolverNames.CADICAL195,
+    ):
+        """
+        :param optimizer: optimizer applied to each partition.
+        :param max_partition_size: maximum number of gates in a single partition.
+        :param max_workers: number of worker processes, defaults to the number of CPUs.
+               If it is 1, partitions are optimized in the current process.
+        :param partition_time_limit: time limit in seconds for optimization of a single
+               partition; partitions exceeding it are left unchanged. Only applied
+               when partitions are optimized in worker processes.
+        :param check_equivalence: if True, the resulting circuit is checked to be
+               equivalent to the original one using SAT-solver.
+        :param solver_name: SAT-solver used for the equivalence check.
+
+        """
+        super().__init__()
+        self._optimizer = optimizer
+        self._max_partition_size = max_partition_size
+        self._max_workers = max_workers
+        self._partition_time_limit = partition_time_limit
+        self._check_equivalence = check_equivalence
+        self._solver_name = solver_name
+
+    def _transform(self, circuit: Circuit) -> Circuit:
+        """
+        :param circuit: the original circuit to be optimized.
+        :return: new optimized version of the circuit.
+
+        """
+        partitions = partition_circuit(circuit, self._max_partition_size)
+        logger.debug(f"Circuit is split into {len(partitions)} partitions")
+        subcircuits = [extract_partition(circuit, p) for p in partitions]
+        optimized = self._optimize_subcircuits(subcircuits)
+
+        result = _stitch(circuit, partitions, subcircuits, optimized)
+
+        if self._check_equivalence:
+            miter = build_miter(circuit, result)
+            if is_circuit_satisfiable(miter, solver_name=self._solver_name).answer:
+                raise FailedValidationError(
+                    "Partitioned optimization produced non-equivalent circuit."
+                )
+        return result
+
+    def _optimize_subcircuits(
+        self,
+        subcircuits: list[Circuit],
+    ) -> list[tp.Optional[Circuit]]:
+        """
+        :return: optimized subcircuits, or None for those which failed to be optimized.
+
+        """
+        max_workers = self._max_workers or os.cpu_count() or 1
+        if max_workers == 1 or len(subcircuits) <= 1:
+            return [_optimize(self._optimizer, sub) for sub in subcircuits]
+
+        results: list[tp.Optional[Circuit]] = [None] * len(subcircuits)
+        with pebble.ProcessPool(max_workers=max_workers) as pool:
+            futures = [
+                pool.schedule(
+                    _optimize,
+                    args=[self._optimizer, sub],
+                    timeout=self._partition_time_limit,
+                )
+                for sub in subcircuits
+            ]
+            for i, future in enumerate(futures):
+                try:
+                    results[i] = future.result()
+                except concurrent.futures.TimeoutError:
+                    logger.debug(f"Partition {i} optimization timed out")
+                except Exception as e:
+                    logger.warning(f"Partition {i} optimization failed: {e!r}")
+        return results
+
+    def __eq__(self, other: tp.Any):
+        if not isinstance(other, PartitionedOptimization):
+            return NotImplemented
+
+        return (
+            super().__eq__(other)
+            and self._optimizer == other._optimizer
+            and self._max_partition_size == other._max_partition_size
+            and self._max_workers == other._max_workers
+            and self._partition_time_limit == other._partition_time_limit
+            and self._check_equivalence == other._check_equivalence
+            and self._solver_name == other._solver_name
+        )
+
+
+def _is_valid_replacement(original: Circuit, optimized: Circuit) -> bool:
+    return (
+        set(optimized.inputs) <= set(original.inputs)
+        and len(optimized.outputs) == len(original.outputs)
+        and optimized.gates_number() < original.gates_number()
+    )
+
+
+def _stitch(
+    circuit: Circuit,
+    partitions: list[Partition],
+    subcircuits: list[Circuit],
+    optimized: list[tp.Optional[Circuit]],
+) -> Circuit:
+    """
+    Builds circuit from partitions, using optimized versions of those which became
+    smaller. Gates of optimized partitions keep their labels if they are labels of the
+    same partition of the original circuit, and are renamed otherwise.
+
+    """
+    result = Circuit()
+    for label in circuit.inputs:
+        result.add_gate(Gate(label, INPUT))
+
+    # Label of a signal of the original circuit in the resulting circuit.
+    signals: dict[Label, Label] = {label: label for label in circuit.inputs}
+
+    for i, (partition, sub, opt) in enumerate(zip(partitions, subcircuits, optimized)):
+        if opt is None or not _is_valid_replacement(sub, opt):
+            opt = sub
+        members = set(partition.gates)
+
+        local: dict[Label, Label] = {label: signals[label] for label in opt.inputs}
+        for _gate in opt.top_sort(inverse=True):
+            if _gate.gate_type == INPUT:
+                continue
+            label = _gate.label
+            if label not in members:
+                label = f'{label}_p{i}'
+                while circuit.has_gate(label) or result.has_gate(label):
+                    label = f'_{label}'
+            result.emplace_gate(
+                label,
+                _gate.gate_type,
+                tuple(local[operand] for operand in _gate.operands),
+            )
+            local[_gate.label] = label
+
+        for output, opt_output in zip(partition.outputs, opt.outputs):
+            signals[output] = local[opt_output]
+
+    result.set_outputs([signals[label] for label in circuit.outputs])
+    return result
@@ -0,0 +1,180 @@
+"""
+Module contains portfolio optimization, which runs several optimization scripts
+(ABC scripts and cirbo pipelines) concurrently on the same circuit and keeps the best
+result.
+
+"""
+
+import concurrent.futures
+import dataclasses
+import enum
+import logging
+import os
+import time
+import typing as tp
+
+import pebble
+
+from cirbo.core.circuit import Circuit
+from cirbo.core.circuit.transformer import Transformer
+
+# Package can be compiled without ABC extension when
+# environment variable DISABLE_ABC_CEXT=1 is set.
+try:
+    from abc_wrapper import run_abc_commands_c
+except ImportError:
+    pass
+
+
+__all__ = [
+    'PortfolioCriterion',
+    'PortfolioResult',
+    'run_portfolio',
+]
+
+
+logger = logging.getLogger(__name__)
+
+
+# Script is either ABC command string (e.g. 'strash; dc2'), or a `Transformer`, or a
+# function taking and returning a circuit.
+Script = tp.Union[str, Transformer, tp.Callable[[Circuit], Circuit]]
+
+
+class PortfolioCriterion(enum.Enum):
+    """Criterion by which the best result of the portfolio is chosen."""
+
+    # Smallest number of gates, ties are broken by depth.
+    SIZE = 'SIZE'
+    # Smallest depth, ties are broken by number of gates.
+    DEPTH = 'DEPTH'
+
+
+@dataclasses.dataclass
+class PortfolioResult:
+    """
+    Result of a single portfolio script.
+
+    :param name: name of the script.
+    :param circuit: optimized circuit.
+    :param size: number of gates of the optimized circuit.
+    :param depth: depth of the optimized circuit, which is the length of its
+        critical path (see `StructuralMetrics`).
+    :param time: time in seconds spent by the script.
+
+    """
+
+    name: str
+    circuit: Circuit
+    size: int
+    depth: int
+    time: float
+
+
+def _run_script(name: str, script: Script, circuit: Circuit) -> PortfolioResult:
+    start = time.monotonic()
+    if isinstance(script, str):
+        bench = run_abc_commands_c(circuit.into_bench().format_circuit(), script)
+        result = Circuit.from_bench_string(bench)
+    elif isinstance(script, Transformer):
+        result = script.transform(circuit)
+    else:
+        result = script(circuit)
+    return PortfolioResult(
+        name=name,
+        circuit=result,
+        size=result.gates_number(),
+        depth=result.get_structural_metrics().critical_path_length,
+        time=time.monotonic() - start,
+    )
+
+
+def _key(result: PortfolioResult, criterion: PortfolioCriterion) -> tuple[int, int]:
+    if criterion == PortfolioCriterion.DEPTH:
+        return result.depth, result.size
+    return result.size, result.depth
+
+
+def run_portfolio(
+    circuit: Circuit,
+    scripts: tp.Mapping[str, Script],
+    *,
+    criterion: tp.Union[PortfolioCriterion, str] = PortfolioCriterion.SIZE,
+    target: tp.Optional[int] = None,
+    max_workers: tp.Optional[int] = None,
+    time_limit: tp.Optional[float] = None,
+) -> PortfolioResult:
+    """
+    Runs several optimization scripts concurrently on the same circuit and returns the
+    best result. Each script is run in a separate process, so scripts don't share any
+    state (in particular, each ABC script gets its own ABC frame).
+
+    Note: original circuit is considered as a result of the script named `original`, so
+    the returned circuit is never worse than the original one.
+
+    :param circuit: circuit to be optimized.
+    :param scripts: mapping from script names to scripts. Script is either an ABC
+        command string (e.g. 'strash; dc2'), or a `Transformer`, or a picklable function
+        taking and returning a circuit.
+    :param criterion: criterion by which the best result is chosen.
+    :param target: if given, the portfolio stops as soon as some script reaches
+        the size (or depth, depending on the criterion) not greater than the target,
+        and the remaining scripts are cancelled.
+    :param max_workers: number of worker processes, defaults to the number of CPUs.
+    :param time_limit: time limit in seconds for a single script; scripts exceeding it
+        are cancelled and ignored.
+    :return: the best result.
+
+    """
+    criterion = PortfolioCriterion(criterion)
+    best = PortfolioResult(
+        name='original',
+        circuit=circuit,
+        size=circuit.gates_number(),
+        depth=circuit.get_structural_metrics().critical_path_length,
+        time=0.0,
+    )
+
+    def _reached_target() -> bool:
+        return target is not None and _key(best, criterion)[0] <= target
+
+    if not scripts or _reached_target():
+        return best
+
+    max_workers = min(max_workers or os.cpu_count() or 1, len(scripts))
+    with pebble.ProcessPool(max_workers=max_workers) as pool:
+        futures = {
+            pool.schedule(
+                _run_script,
+                args=[name, script, circuit],
+                timeout=time_limit,
+            ): name
+            for name, script in scripts.items()
+        }
+        pending = set(futures)
+        while pending and not _reached_target():
+            done, pending = concurrent.futures.wait(
+                pending,
+                return_when=concurrent.futures.FIRST_COMPLETED,
+            )
+            for future in done:
+                try:
+                    result = future.result()
+                except concurrent.futures.TimeoutError:
+                    logger.debug(f"Script {futures[future]} timed out")
+                    continue
+                except Exception as e:
+                    logger.warning(f"Script {futures[future]} failed: {e!r}")
+                    continue
+
+                logger.debug(
+                    f"Script {result.name}: size {result.size}, "
+                    f"depth {result.depth}, time {result.time:.2f}s"
+                )
+                if _key(result, criterion) < _key(best, criterion):
+                    best = result
+
+        for future in pending:
+            future.cancel()
+
+    return best
@@ -0,0 +1,622 @@
+"""
+Module contains simulation-driven resubstitution, which re-expresses gates of a circuit
+as functions of other gates already present in it (divisors).
+
+"""
+
+import collections
+import itertools
+import logging
+import random
+import typing as tp
+
+from cirbo.core.circuit import (
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+    AND,
+    Circuit,
+    Gate,
+    GateType,
+    GEQ,
+    GT,
+    IFF,
+    INPUT,
+    Label,
+    LEQ,
+    LT,
+    NAND,
+    NOR,
+    NOT,
+    NXOR,
+    OR,
+    XOR,
+)
+from cirbo.core.circuit.metrics import FREE_GATE_TYPES
+from cirbo.core.circuit.simulation import bit_operator
+from cirbo.core.circuit.transformer import Transformer
+from cirbo.minimization.simplification import RemoveRedundantGates
+from cirbo.sat.sat import is_circuit_satisfiable, PySATSolverNames
+from cirbo.synthesis.circuit_search import Basis, resolve_basis
+
+
+__all__ = [
+    'Resubstitution',
+]
+
+
+logger = logging.getLogger(__name__)
+
+
+_BINARY_GATE_TYPES = (AND, NAND, OR, NOR, XOR, NXOR, GT, LT, GEQ, LEQ)
+
+# Circuits with at most this number of inputs are simulated exhaustively, so found
+# candidates are exact and are not verified by SAT-solver.
+_EXHAUSTIVE_SIMULATION_MAX_INPUTS = 10
+
+# Maximum number of counterexamples added to the simulation while resubstituting
+# single gate.
+_MAX_COUNTEREXAMPLES_PER_GATE = 3
+
+# Candidate is a function of divisors: root gate type and its operands, where each
+# operand is either a divisor label or a candidate for inner gate.
+_Candidate = tuple[GateType, tuple[tp.Union[Label, '_Candidate'], ...]]
+
+
+class Resubstitution(Transformer):
+    """
+    Simulation-driven resubstitution. Each gate is tried to be re-expressed as a
+    function of gates already present in the circuit (divisors) using at most two new
+    gates of the basis, so that the gates used only by it (its maximum fanout-free
+    cone) become redundant and the circuit gets smaller.
+
+    Candidates are found by comparing simulation signatures of gates: exhaustive ones
+    for circuits with few inputs, or random ones, in which case each candidate is
+    verified using SAT-solver and counterexamples refine the simulation.
+
+    Note: size is counted as in `Circuit.gates_number`, i.e. negations are free.
+
+    """
+
+    def __init__(
+        self,
+        basis: tp.Union[str, Basis] = Basis.XAIG,
+        *,
+        max_divisors: int = 40,
+        max_inserted_gates: int = 2,
+        simulation_size: int = 1024,
+        seed: int = 0,
+        solver_name: tp.Union[PySATSolverNames, str] = PySATSolverNames.CADICAL195,
+    ):
+        """
+        :param basis: basis of gates inserted into the circuit.
+        :param max_divisors: maximum number of divisors considered for a single gate.
+        :param max_inserted_gates: maximum number of new (not free) gates used to
+               re-express single gate, from 0 to 2.
+        :param simulation_size: number of random input assignments used to simulate
+               circuits with many inputs.
+        :param seed: seed of the random input assignments.
+        :param solver_name: SAT-solver used to verify candidates.
+
+        """
+        super().__init__(post_transformers=(RemoveRedundantGates(),))
+        self._basis = resolve_basis(basis)
+        self._max_divisors = max_divisors
+        self._max_inserted_gates = max_inserted_gates
+        self._simulation_size = simulation_size
+        self._seed = seed
+        self._solver_name = solver_name
+
+    def _transform(self, circuit: Circuit) -> Circuit:
+        """
+        :param circuit: the original circuit to be simplified.
+        :return: new simplified version of the circuit.
+
+        """
+        return _Resubstitutor(
+            circuit,
+            basis=self._basis,
+            max_divisors=self._max_divisors,
+            max_inserted_gates=self._max_inserted_gates,
+            simulation_size=self._simulation_size,
+            seed=self._seed,
+            solver_name=self._solver_name,
+        ).run()
+
+    def __eq__(self, other: tp.Any):
+        if not isinstance(other, Resubstitution):
+            return NotImplemented
+
+        return (
+            super().__eq__(other)
+            and self._basis == other._basis
+            and self._max_divisors == other._max_divisors
+            and self._max_inserted_gates == other._max_inserted_gates
+            and self._simulation_size == other._simulation_size
+            and self._seed == other._seed
+            and self._solver_name == other._solver_name
+        )
+
+
+def _simulate_gate(gate_type: GateType, operands: list[int], mask: int) -> int:
+    """
+    Evaluate signature of a gate by signatures of its operands.
+
+    :param gate_type: type of the gate.
+    :param operands: signatures of gate operands.
+    :param mask: signature of constant true.
+    :return: signature of the gate.
+
+    """
+    return bit_operator(gate_type)(mask, *operands)
+
+
+def _truth_table(gate_type: GateType) -> tuple[bool, bool, bool, bool]:
+    """
+    :return: values of binary gate on (0, 0), (0, 1), (1, 0) and (1, 1).
+
+    """
+    return tp.cast(
+        tuple[bool, bool, bool, bool],
+        tuple(
+            bool(gate_type.operator(a, b))
+            for a, b in itertools.product((False, True), repeat=2)
+        ),
+    )
+
+
+def _apply_truth_table(
+    truth_table: tuple[bool, ...], lhs: int, rhs: int, mask: int
+) -> int:
+    not_lhs, not_rhs = mask ^ lhs, mask ^ rhs
+    return (
+        (not_lhs & not_rhs if truth_table[0] else 0)
+        | (not_lhs & rhs if truth_table[1] else 0)
+        | (lhs & not_rhs if truth_table[2] else 0)
+        | (lhs & rhs if truth_table[3] else 0)
+    )
+
+
+def _required_operand(
+    truth_table: tuple[bool, ...],
+    known: int,
+    target: int,
+    mask: int,
+    *,
+    known_is_first: bool,
+) -> tp.Optional[tuple[int, int]]:
+    """
+    Find the signature of the unknown operand of a binary gate, such that the gate
+    computes the `target`, given the signature of the other (known) operand.
+
+    :return: pair (signature, care) meaning that the unknown operand must equal the
+        signature on positions from care, or None if there is no such operand.
+
+    """
+    value: int = 0
+    care: int = 0
+    for known_value, positions in ((False, mask ^ known), (True, known)):
+        if known_is_first:
+            on_false = truth_table[2 * known_value]
+            on_true = truth_table[2 * known_value + 1]
+        else:
+            on_false, on_true = truth_table[known_value], truth_table[2 + known_value]
+        if on_false == on_true:
+            expected: int = mask if on_false else 0
+            if (target ^ expected) & positions:
+                return None
+        else:
+            care |= positions
+            value |= (target if on_true else mask ^ target) & positions
+    return value, care
+
+
+class _Resubstitutor:
+    """Working state of resubstitution of a single circuit."""
+
+    def __init__(
+        self,
+        circuit: Circuit,
+        *,
+        basis: Basis,
+        max_divisors: int,
+        max_inserted_gates: int,
+        simulation_size: int,
+        seed: int,
+        solver_name: tp.Union[PySATSolverNames, str],
+    ):
+        self._inputs: list[Label] = list(circuit.inputs)
+        self._outputs: list[Label] = list(circuit.outputs)
+        self._max_divisors = max_divisors
+        self._max_inserted_gates = max_inserted_gates
+        self._solver_name = solver_name
+
+        _operations = {op.value for op in basis.value}
+        self._gate_types: list[tuple[GateType, tuple[bool, ...]]] = [
+            (gate_type, _truth_table(gate_type))
+            for gate_type in _BINARY_GATE_TYPES
+            if ''.join(str(int(x)) for x in _truth_table(gate_type)) in _operations
+        ]
+
+        self._types: dict[Label, GateType] = {}
+        self._operands: dict[Label, tuple[Label, ...]] = {}
+        self._users: dict[Label, collections.Counter] = collections.defaultdict(
+            collections.Counter
+        )
+        self._order: list[Label] = []
+        for gate in circuit.top_sort(inverse=True):
+            self._types[gate.label] = gate.gate_type
+            self._operands[gate.label] = gate.operands
+            self._order.append(gate.label)
+            for operand in gate.operands:
+                self._users[operand][gate.label] += 1
+
+        self._exhaustive = len(self._inputs) <= _EXHAUSTIVE_SIMULATION_MAX_INPUTS
+        self._inputs_signatures: dict[Label, int]
+        if self._exhaustive:
+            self._mask = (1 << (1 << len(self._inputs))) - 1
+            self._inputs_signatures = {
+                label: sum(
+                    1 << t for t in range(1 << len(self._inputs)) if (t >> i) & 1
+                )
+                for i, label in enumerate(self._inputs)
+            }
+        else:
+            self._mask = (1 << simulation_size) - 1
+            rng = random.Random(seed)
+            self._inputs_signatures = {
+                label: rng.getrandbits(simulation_size) for label in self._inputs
+            }
+        self._signatures: dict[Label, int] = {}
+        self._simulate()
+        self._new_labels = 0
+
+    def run(self) -> Circuit:
+        for label in self._order:
+            if label not in self._types or self._types[label] in FREE_GATE_TYPES:
+                continue
+            self._resubstitute(label)
+        return self._build_circuit()
+
+    def _simulate(self):
+        self._signatures = dict(self._inputs_signatures)
+        for label in self._topological_order(self._types):
+            if self._types[label] == INPUT:
+                continue
+            self._signatures[label] = _simulate_gate(
+                self._types[label],
+                [self._signatures[operand] for operand in self._operands[label]],
+                self._mask,
+            )
+
+    def _add_counterexample(self, assignment: dict[Label, bool]):
+        """Extend signatures of inputs by one more (distinguishing) assignment."""
+        self._mask = (self._mask << 1) | 1
+        self._inputs_signatures = {
+            label: (signature << 1) | int(assignment.get(label, False))
+            for label, signature in self._inputs_signatures.items()
+        }
+        self._simulate()
+
+    def _topological_order(self, labels: tp.Iterable[Label]) -> list[Label]:
+        """
+        :return: given gates sorted in topological order (operands go first).
+
+        """
+        labels_lst: list[Label] = list(labels)
+        labels_set: set[Label] = set(labels_lst)
+        order: list[Label] = []
+        visited: set[Label] = set()
+        for root in labels_lst:
+            stack: list[tuple[Label, bool]] = [(root, False)]
+            while stack:
+                label, is_exit = stack.pop()
+                if is_exit:
+                    order.append(label)
+                    continue
+                if label in visited:
+                    continue
+                visited.add(label)
+                stack.append((label, True))
+                stack.extend(
+                    (operand, False)
+                    for operand in self._operands[label]
+                    if operand in labels_set and operand not in visited
+                )
+        return order
+
+    def _mffc(self, label: Label) -> set[Label]:
+        """
+        :return: maximum fanout-free cone of the gate: gates which become redundant if
+            the gate is removed.
+
+        """
+        outputs: set[Label] = set(self._outputs)
+        references: dict[Label, int] = {}
+        cone: set[Label] = {label}
+        stack: list[Label] = [label]
+        while stack:
+            current = stack.pop()
+            for operand in self._operands[current]:
+                if self._types[operand] == INPUT or operand in outputs:
+                    continue
+                if operand not in references:
+                    references[operand] = sum(self._users[operand].values())
+                references[operand] -= 1
+                if references[operand] == 0:
+                    cone.add(operand)
+                    stack.append(operand)
+        return cone
+
+    def _divisors(self, label: Label, mffc: set[Label]) -> list[Label]:
+        """
+        Collect gates which can be used to re-express the gate: gates of its transitive
+        fanin, except its maximum fanout-free cone, and then gates depending only on
+        already collected divisors. None of them is in the transitive fanout of the
+        gate, so the replacement never introduces a cycle.
+
+        """
+        divisors: list[Label] = []
+        visited: set[Label] = {label}
+        queue: tp.Deque[Label] = collections.deque(self._operands[label])
+        while queue and len(divisors) < self._max_divisors:
+            current = queue.popleft()
+            if current in visited:
+                continue
+            visited.add(current)
+            if current not in mffc:
+                divisors.append(current)
+            queue.extend(self._operands[current])
+
+        divisors_set: set[Label] = set(divisors)
+        for divisor in divisors:
+            if len(divisors) >= self._max_divisors:
+                break
+            for user in self._users[divisor]:
+                if (
+                    user not in divisors_set
+                    and user not in mffc
+                    and all(operand in divisors_set for operand in self._operands[user])
+                ):
+                    divisors.append(user)
+                    divisors_set.add(user)
+        return divisors
+
+    def _find_candidate(
+        self, label: Label, divisors: list[Label], max_cost: int
+    ) -> tp.Optional[_Candidate]:
+        """
+        Find function of divisors equal to the gate on the current simulation, which
+        uses less than `max_cost` new (not free) gates.
+
+        """
+        mask: int = self._mask
+        target: int = self._signatures[label]
+        signatures: dict[int, Label] = {}
+        for divisor in divisors:
+            signatures.setdefault(self._signatures[divisor], divisor)
+
+        # 0 new gates: constant, existing gate or its negation.
+        if target == 0:
+            return ALWAYS_FALSE, ()
+        if target == mask:
+            return ALWAYS_TRUE, ()
+        if target in signatures:
+            return IFF, (signatures[target],)
+        if mask ^ target in signatures:
+            return NOT, (signatures[mask ^ target],)
+        if max_cost <= 1 or self._max_inserted_gates < 1:
+            return None
+
+        # 1 new gate over two divisors.
+        for first in divisors:
+            for gate_type, truth_table in self._gate_types:
+                required = _required_operand(
+                    truth_table, self._signatures[first], target, mask,
+                    known_is_first=True,
+                )
+                if required is None:
+                    continue
+                value, care = required
+                if care == mask:
+                    second = signatures.get(value)
+                    if second is not None and second != first:
+                        return gate_type, (first, second)
+                    continue
+                for second in divisors:
+                    if second == first:
+                        continue
+                    if not (self._signatures[second] ^ value) & care:
+                        return gate_type, (first, second)
+        if max_cost <= 2 or self._max_inserted_gates < 2:
+            return None
+
+        # 2 new gates: root over a divisor and an inner gate over two divisors.
+        inner: list[tuple[int, _Candidate]] = [
+            (
+                _apply_truth_table(
+                    truth_table, self._signatures[first], self._signatures[second], mask
+                ),
+                (gate_type, (first, second)),
+            )
+            for first, second in itertools.combinations(divisors, 2)
+            for gate_type, truth_table in self._gate_types
+        ]
+        inner_signatures: dict[int, _Candidate] = {}
+        for signature, candidate in inner:
+            inner_signatures.setdefault(signature, candidate)
+        for divisor in divisors:
+            for gate_type, truth_table in self._gate_types:
+                required = _required_operand(
+                    truth_table, self._signatures[divisor], target, mask,
+                    known_is_first=False,
+                )
+                if required is None:
+                    continue
+                value, care = required
+                if care == mask:
+                    if value in inner_signatures:
+                        return gate_type, (inner_signatures[value], divisor)
+                    continue
+                for signature, candidate in inner:
+                    if not (signature ^ value) & care:
+                        return gate_type, (candidate, divisor)
+        return None
+
+    def _verify(self, label: Label, candidate: _Candidate) -> tp.Optional[dict]:
+        """
+        Check that the candidate is equivalent to the gate using SAT-solver.
+
+        :return: None if they are equivalent, otherwise distinguishing assignment of
+            circuit inputs.
+
+        """
+        miter = Circuit()
+        used: list[Label] = [label] + list(self._candidate_divisors(candidate))
+        cone: set[Label] = set()
+        stack: list[Label] = list(used)
+        while stack:
+            current = stack.pop()
+            if current in cone:
+                continue
+            cone.add(current)
+            stack.extend(self._operands[current])
+        for current in self._topological_order(cone):
+            if self._types[current] == INPUT:
+                miter.add_gate(Gate(current, INPUT))
+            else:
+                miter.emplace_gate(
+                    current, self._types[current], self._operands[current]
+                )
+
+        root = self._emplace_candidate(miter, candidate, self._fresh_label)
+        difference = self._fresh_label()
+        miter.emplace_gate(difference, XOR, (label, root))
+        miter.mark_as_output(difference)
+
+        result = is_circuit_satisfiable(miter, solver_name=self._solver_name)
+        if not result.answer:
+            return None
+        model = tp.cast(list[int], result.model)
+        return {input: model[i] > 0 for i, input in enumerate(miter.inputs)}
+
+    @staticmethod
+    def _candidate_divisors(candidate: _Candidate) -> tp.Iterable[Label]:
+        for operand in candidate[1]:
+            if isinstance(operand, tuple):
+                yield from _Resubstitutor._candidate_divisors(operand)
+            else:
+                yield operand
+
+    @staticmethod
+    def _candidate_cost(candidate: _Candidate) -> int:
+        return int(candidate[0] not in FREE_GATE_TYPES) + sum(
+            _Resubstitutor._candidate_cost(operand)
+            for operand in candidate[1]
+            if isinstance(operand, tuple)
+        )
+
+    @staticmethod
+    def _emplace_candidate(
+        circuit: Circuit,
+        candidate: _Candidate,
+        new_label: tp.Callable[[], Label],
+        root_label: tp.Optional[Label] = None,
+    ) -> Label:
+        operands = tuple(
+            (
+                _Resubstitutor._emplace_candidate(circuit, operand, new_label)
+                if isinstance(operand, tuple)
+                else operand
+            )
+            for operand in candidate[1]
+        )
+        label = new_label() if root_label is None else root_label
+        circuit.emplace_gate(label, candidate[0], operands)
+        return label
+
+    def _fresh_label(self) -> Label:
+        while True:
+            self._new_labels += 1
+            label = f'resub_{self._new_labels}'
+            if label not in self._types:
+                return label
+
+    def _resubstitute(self, label: Label):
+        mffc: set[Label] = self._mffc(label)
+        cost: int = sum(1 for x in mffc if self._types[x] not in FREE_GATE_TYPES)
+        divisors: list[Label] = self._divisors(label, mffc)
+
+        for _ in range(_MAX_COUNTEREXAMPLES_PER_GATE + 1):
+            candidate = self._find_candidate(label, divisors, cost)
+            if candidate is None:
+                return
+            if not self._exhaustive:
+                counterexample = self._verify(label, candidate)
+                if counterexample is not None:
+                    self._add_counterexample(counterexample)
+                    continue
+            logger.debug(
+                f"Resubstituted {label} ({cost} gates) with {candidate} "
+                f"({self._candidate_cost(candidate)} gates)"
+            )
+            self._replace(label, mffc, candidate)
+            return
+
+    def _remove_gate(self, label: Label):
+        for operand in self._operands[label]:
+            self._users[operand][label] -= 1
+            if self._users[operand][label] == 0:
+                del self._users[operand][label]
+        del self._types[label]
+        del self._operands[label]
+        self._signatures.pop(label, None)
+
+    def _set_gate(self, label: Label, gate_type: GateType, operands: tuple[Label, ...]):
+        self._types[label] = gate_type
+        self._operands[label] = operands
+        for operand in operands:
+            self._users[operand][label] += 1
+        self._signatures[label] = _simulate_gate(
+            gate_type, [self._signatures[operand] for operand in operands], self._mask
+        )
+
+    def _replace(self, label: Label, mffc: set[Label], candidate: _Candidate):
+        signature = self._signatures[label]
+        for gate in mffc:
+            self._remove_gate(gate)
+
+        gate_type, operands = candidate
+        if gate_type == IFF:
+            # gate is equal to existing one, so its users are relinked to it.
+            (divisor,) = operands
+            for user in list(self._users[label]):
+                self._users[divisor][user] += self._users[label][user]
+                self._operands[user] = tuple(
+                    divisor if operand == label else operand
+                    for operand in self._operands[user]
+                )
+            del self._users[label]
+            self._outputs = [divisor if x == label else x for x in self._outputs]
+            return
+
+        new_operands: list[Label] = []
+        for operand in operands:
+            if isinstance(operand, tuple):
+                inner_label = self._fresh_label()
+                self._set_gate(inner_label, operand[0], tp.cast(tuple, operand[1]))
+                new_operands.append(inner_label)
+            else:
+                new_operands.append(operand)
+        self._set_gate(label, gate_type, tuple(new_operands))
+        assert self._signatures[label] == signature
+
+    def _build_circuit(self) -> Circuit:
+        circuit = Circuit()
+        for label in self._topological_order(self._types):
+            if self._types[label] == INPUT:
+                circuit.add_gate(Gate(label, INPUT))
+            else:
+                circuit.emplace_gate(label, self._types[label], self._operands[label])
+        circuit.set_inputs(self._inputs)
+        circuit.set_outputs(self._outputs)
+        return circuit
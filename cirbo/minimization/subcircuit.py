@@ -1,26 +1,26 @@
 import collections
 import copy
 import enum
+import functools
 import itertools
 import logging
+import operator
 import typing as tp
 import uuid
 
 import mockturtle_wrapper as mw
 import more_itertools
 
+from cirbo.circuits_db.db import CircuitsDatabase
 from cirbo.core.boolean_function import RawTruthTableModel
 from cirbo.core.circuit import Circuit
 from cirbo.core.circuit.exceptions import CircuitValidationError
 from cirbo.core.circuit.gate import Label
-from cirbo.core.circuit.operators import GateState, Undefined
+from cirbo.core.circuit.simulation import bit_operator
 from cirbo.core.circuit.validation import check_circuit_has_no_cycles
 from cirbo.core.logic import DontCare
 from cirbo.core.truth_table import TruthTableModel
-from cirbo.minimization.exception import (
-    FailedValidationError,
-    UnsupportedOperationError,
-)
+from cirbo.minimization.exception import FailedValidationError
 from cirbo.sat.miter import build_miter
 from cirbo.sat.sat import is_circuit_satisfiable
 from cirbo.synthesis.circuit_search import Basis, CircuitFinderSat, resolve_basis
@@ -28,6 +28,18 @@ from cirbo.synthesis.exception import NoSolutionError, SolverTimeOutError
 
 Cut = tuple[Label, ...]
 
+# Database lookup with don't cares enumerates all their substitutions,
+# so it is only performed for windows with few don't care positions.
+_DB_LOOKUP_MAX_DONT_CARES = 8
+
+# Observability don't cares are evaluated for all combinations of subcircuit outputs
+# values, so they are only evaluated for subcircuits with few outputs.
+_ODC_MAX_OUTPUTS = 4
+
+# Subcircuits with at least this number of inputs are synthesized in CEGIS mode, which
+# encodes only truth table rows required to refute wrong candidates.
+_CEGIS_MIN_INPUTS = 6
+
 logger = logging.getLogger(__name__)
 
 __all__ = ['minimize_subcircuits']
@@ -39,45 +51,6 @@ class _NodeState(enum.Enum):
     REMOVED = 'REMOVED'
 
 
-class _PatternOperations:
-    """
-    Structure to evaluate patterns for small subcircuits. Pattern is an integer
-    representation of truth table row for a gate.
-
-    Method `eval_pattern` is used to get gate's pattern by patterns of its operands.
-
-    """
-
-    def __init__(self, number_of_inputs: int):
-        self.max_pattern: int = (1 << (1 << number_of_inputs)) - 1
-
-    def eval_pattern(self, operands: list[int], oper_type: str) -> int:
-        if oper_type == 'NOT':
-            return self.max_pattern - operands[0]
-        elif oper_type == 'AND':
-            return operands[0] & operands[1]
-        elif oper_type == 'NAND':
-            return self.max_pattern - (operands[0] & operands[1])
-        elif oper_type == 'OR':
-            return operands[0] | operands[1]
-        elif oper_type == 'NOR':
-            return self.max_pattern - (operands[0] | operands[1])
-        elif oper_type == 'XOR':
-            return operands[0] ^ operands[1]
-        elif oper_type == 'NXOR':
-            return self.max_pattern - (operands[0] ^ operands[1])
-        elif oper_type == 'GEQ':
-            return operands[0] | (self.max_pattern - operands[1])
-        elif oper_type == 'LT':
-            return self.max_pattern - (operands[0] | (self.max_pattern - operands[1]))
-        elif oper_type == 'LEQ':
-            return (self.max_pattern - operands[0]) | operands[1]
-        elif oper_type == 'GT':
-            return self.max_pattern - ((self.max_pattern - operands[0]) | operands[1])
-        else:
-            raise UnsupportedOperationError()
-
-
 class _Subcircuit:
     def __init__(
         self,
@@ -98,25 +71,38 @@ class _Subcircuit:
         self.patterns: tp.DefaultDict[Label, int] = (
             collections.defaultdict(int) if patterns is None else patterns
         )
+        self.odc: dict[Label, int] = dict()  # rows of outputs which are not observable
+        self.dont_cares_epoch: int = 0  # epoch in which don't cares were evaluated
+        self.lower_bound: int = 0
+
+    @property
+    def gain(self) -> int:
+        """Estimated number of gates that can be saved by resynthesis of this
+        subcircuit."""
+        return self.size - self.lower_bound
 
     def evaluate_truth_table_with_dont_cares(self) -> RawTruthTableModel:
         """
         Return truth table with don't cares based on possible inputs assignments (stored
-        in `inputs_tt` field).
+        in `inputs_tt` field) and on outputs observability (stored in `odc` field).
 
         :return: truth table for outputs.
 
         """
         output_patterns: list[int] = [self.patterns[gate] for gate in self.outputs]
+        output_odc: list[int] = [self.odc.get(gate, 0) for gate in self.outputs]
         truth_table: RawTruthTableModel = [list() for _ in output_patterns]
         n = len(self.inputs)
+        inputs_tt: set[str] = set(self.inputs_tt)
 
-        for i in itertools.product(('0', '1'), repeat=n):
+        for row, i in enumerate(itertools.product(('0', '1'), repeat=n)):
             assignment: str = ''.join(i)
             for j, pattern in enumerate(output_patterns):
                 output_patterns[j] >>= 1
                 truth_table[j].append(
-                    bool(pattern & 1) if assignment in self.inputs_tt else DontCare
+                    bool(pattern & 1)
+                    if assignment in inputs_tt and not (output_odc[j] >> row) & 1
+                    else DontCare
                 )
 
         return truth_table
@@ -137,6 +123,64 @@ def _generate_inputs_tt(size: int) -> list[int]:
     return inputs_tt
 
 
+def _build_subcircuit(
+    circuit: Circuit,
+    inputs: list[Label],
+    nodes: list[Label],
+    outputs_set: set[Label],
+    inputs_tt: list[int],
+) -> _Subcircuit:
+    """
+    Build subcircuit by its inputs and nodes and evaluate patterns of its gates.
+
+    :param circuit: given circuit.
+    :param inputs: inputs of the subcircuit.
+    :param nodes: all nodes of the subcircuit (including inputs) in top_sort order.
+    :param outputs_set: set of the circuit outputs.
+    :param inputs_tt: patterns of inputs (see `_generate_inputs_tt`).
+    :return: subcircuit with evaluated patterns.
+
+    """
+    n: int = len(inputs)
+    inputs_set: set[Label] = set(inputs)
+    nodes_set: set[Label] = set(nodes)
+    outputs: list[Label] = list()
+
+    circuit_tt: tp.DefaultDict[Label, int] = collections.defaultdict(int)
+    circuit_size: int = 0
+    max_pattern: int = (1 << (1 << n)) - 1
+    for i, node in enumerate(inputs):
+        circuit_tt[node] = inputs_tt[i]
+    for node in nodes:
+        if node in inputs_set:
+            continue
+
+        operands: tuple[Label, ...] = circuit.get_gate(node).operands
+        users: list[Label] = circuit.get_gate_users(node)
+        oper_type: str = circuit.get_gate(node).gate_type.name
+        circuit_tt[node] = bit_operator(circuit.get_gate(node).gate_type)(
+            max_pattern, *(circuit_tt[operand] for operand in operands)
+        )
+
+        if oper_type != 'NOT':
+            circuit_size += 1
+        is_output: bool = node in outputs_set
+        if not is_output:
+            for user in users:
+                if user not in nodes_set:
+                    is_output = True
+                    break
+        if is_output:
+            outputs.append(node)
+    return _Subcircuit(
+        inputs=inputs[::-1],
+        gates=nodes,
+        outputs=outputs,
+        size=circuit_size,
+        patterns=circuit_tt,
+    )
+
+
 def _get_subcircuits(
     circuit: Circuit,
     cuts: list[Cut],
@@ -227,87 +271,415 @@ def _get_subcircuits(
     }
 
     for cut in good_cuts:
-        n: int = len(cut)
-        inputs: set[Label] = set(cut)
-        inputs_lst: list[Label] = list(inputs)
-        outputs: list[Label] = list()
-        nodes: list[Label] = sorted(list(cut_nodes[cut]), key=lambda x: node_pos[x])
-
-        circuit_tt: tp.DefaultDict[Label, int] = collections.defaultdict(int)
-        circuit_size: int = 0
-        pattern_operations: _PatternOperations = _PatternOperations(n)
-        for i, node in enumerate(inputs_lst):
-            circuit_tt[node] = inputs_tt[n][i]
-        for node in nodes:
-            if node in inputs:
-                continue
-
-            operands: tuple[Label, ...] = circuit.get_gate(node).operands
-            users: list[Label] = circuit.get_gate_users(node)
-            oper_type: str = circuit.get_gate(node).gate_type.name
-            circuit_tt[node] = pattern_operations.eval_pattern(
-                [circuit_tt[operand] for operand in operands], oper_type
+        subcircuits.append(
+            _build_subcircuit(
+                circuit,
+                list(set(cut)),
+                sorted(list(cut_nodes[cut]), key=lambda x: node_pos[x]),
+                outputs_set,
+                inputs_tt[len(cut)],
             )
+        )
+    return subcircuits
 
-            if oper_type != 'NOT':
-                circuit_size += 1
-            is_output: bool = node in outputs_set
-            if not is_output:
-                for user in users:
-                    if user not in cut_nodes[cut]:
-                        is_output = True
-                        break
-            if is_output:
-                outputs.append(node)
+
+def _get_windows(
+    circuit: Circuit,
+    windows: list[tuple[list[Label], list[Label]]],
+) -> list[_Subcircuit]:
+    """
+    Build subcircuits for reconvergence-driven windows of the circuit. Unlike cuts,
+    windows may be larger than `cut_size`, have several outputs and reconvergent paths
+    inside, which gives exact synthesis more room for improvement.
+
+    :param circuit: given circuit.
+    :param windows: pairs of window leaves and gates (see `mw.enumerate_windows`).
+    :return: list with subcircuits from the given circuit.
+
+    """
+    node_pos: dict[Label, int] = {
+        node.label: i for i, node in enumerate(circuit.top_sort(inverse=True))
+    }
+    outputs_set: set[Label] = set(circuit.outputs)
+    inputs_tt: dict[int, list[int]] = {}
+    subcircuits: list[_Subcircuit] = list()
+
+    for leaves, gates in windows:
+        nodes: set[Label] = set(leaves) | set(gates)
+        if not all(
+            operand in nodes
+            for gate in gates
+            for operand in circuit.get_gate(gate).operands
+        ):
+            # may happen if several constant gates share one network node
+            continue
+        if len(leaves) not in inputs_tt:
+            inputs_tt[len(leaves)] = _generate_inputs_tt(len(leaves))
         subcircuits.append(
-            _Subcircuit(
-                inputs=inputs_lst[::-1],
-                gates=nodes,
-                outputs=outputs,
-                size=circuit_size,
-                patterns=circuit_tt,
+            _build_subcircuit(
+                circuit,
+                list(leaves),
+                sorted(nodes, key=lambda x: node_pos[x]),
+                outputs_set,
+                inputs_tt[len(leaves)],
             )
         )
+
+    logger.debug(f"Process: {len(subcircuits)} windows")
     return subcircuits
 
 
+def _simulate_circuit(circuit: Circuit) -> dict[Label, int]:
+    """
+    Evaluate patterns of all circuit gates on all assignments of circuit inputs at
+    once. Bit `i` of the pattern is gate's value on assignment number `i`, where the
+    last input of the circuit is the least significant bit of the assignment number.
+
+    :param circuit: given circuit.
+    :return: mapping of gate labels to their patterns.
+
+    """
+    inputs: list[Label] = circuit.inputs
+    inputs_tt: list[int] = _generate_inputs_tt(len(inputs))
+    max_pattern: int = (1 << (1 << len(inputs))) - 1
+    patterns: dict[Label, int] = {
+        input: inputs_tt[len(inputs) - 1 - i] for i, input in enumerate(inputs)
+    }
+    for gate in circuit.top_sort(inverse=True):
+        if gate.label not in patterns:
+            patterns[gate.label] = bit_operator(gate.gate_type)(
+                max_pattern, *(patterns[operand] for operand in gate.operands)
+            )
+    return patterns
+
+
+def _get_observability_region(
+    circuit: Circuit,
+    subcircuit: _Subcircuit,
+    levels: int,
+) -> tp.Optional[tuple[list[Label], list[Label]]]:
+    """
+    Get gates in the transitive fanout of subcircuit outputs (at most `levels` gates
+    away from them) and the roots of this region, i.e. gates whose changes are
+    considered observable: circuit outputs and gates used outside the region (users
+    inside the subcircuit do not matter, since the whole subcircuit is replaced).
+
+    :param circuit: given circuit.
+    :param subcircuit: subcircuit for which the region is built.
+    :param levels: maximum distance from subcircuit outputs.
+    :return: region gates in top_sort order and roots of the region, or None if the
+        region reaches subcircuit inputs (i.e. subcircuit inputs depend on its outputs).
+
+    """
+    window: set[Label] = set(subcircuit.gates)
+    region: set[Label] = set()
+    queue: tp.Deque[tuple[Label, int]] = collections.deque(
+        (output, 0) for output in subcircuit.outputs
+    )
+    while queue:
+        label, level = queue.popleft()
+        if level == levels:
+            continue
+        for user in circuit.get_gate_users(label):
+            if user not in window and user not in region:
+                region.add(user)
+                queue.append((user, level + 1))
+    if region & set(subcircuit.inputs):
+        return None
+
+    outputs_set: set[Label] = set(circuit.outputs)
+    scope: set[Label] = region | set(subcircuit.outputs)
+    roots: list[Label] = [
+        label
+        for label in scope
+        if label in outputs_set
+        or any(
+            user not in scope and user not in window
+            for user in circuit.get_gate_users(label)
+        )
+    ]
+    region_lst: list[Label] = [
+        gate.label
+        for gate in circuit.top_sort(inverse=True)
+        if gate.label in region
+    ]
+    return region_lst, roots
+
+
+def _eval_observability_dont_cares(
+    circuit: Circuit,
+    subcircuit: _Subcircuit,
+    simulation: dict[Label, int],
+    levels: int,
+) -> dict[Label, int]:
+    """
+    Evaluate observability don't cares of subcircuit outputs by resimulation of their
+    bounded transitive fanout (see `_get_observability_region`). Output's value on
+    some circuit assignment is don't care if its flip does not change any root of the
+    region for any values of other subcircuit outputs, so outputs can be changed
+    simultaneously on their don't cares.
+
+    Resimulation stays in Python: patterns span all circuit assignments, so each
+    region gate costs one bitwise operation on integers, which runs natively over
+    their machine words. A native pass would also have to receive the circuit anew
+    after every replacement, since replacements change it between evaluations.
+
+    :param circuit: given circuit.
+    :param subcircuit: subcircuit for don't cares evaluation.
+    :param simulation: patterns of circuit gates (see `_simulate_circuit`).
+    :param levels: maximum distance of resimulated gates from subcircuit outputs.
+    :return: mapping of subcircuit outputs to patterns of circuit assignments on
+        which they are not observable.
+
+    """
+    outputs: list[Label] = subcircuit.outputs
+    if not outputs or len(outputs) > _ODC_MAX_OUTPUTS:
+        return {}
+    observability_region = _get_observability_region(circuit, subcircuit, levels)
+    if observability_region is None:
+        return {}
+    region, roots = observability_region
+
+    max_pattern: int = (1 << (1 << len(circuit.inputs))) - 1
+    roots_values: list[list[int]] = []
+    for values in range(1 << len(outputs)):
+        patterns: dict[Label, int] = {
+            output: max_pattern if (values >> j) & 1 else 0
+            for j, output in enumerate(outputs)
+        }
+        for label in region:
+            gate = circuit.get_gate(label)
+            patterns[label] = bit_operator(gate.gate_type)(
+                max_pattern,
+                *(
+                    patterns.get(operand, simulation[operand])
+                    for operand in gate.operands
+                ),
+            )
+        roots_values.append([patterns[root] for root in roots])
+
+    dont_cares: dict[Label, int] = {}
+    for j, output in enumerate(outputs):
+        observable: int = 0
+        for values in range(1 << len(outputs)):
+            if (values >> j) & 1:
+                continue
+            for lhs, rhs in zip(roots_values[values], roots_values[values | (1 << j)]):
+                observable |= lhs ^ rhs
+        dont_cares[output] = max_pattern - observable
+    return dont_cares
+
+
 def _eval_dont_cares(
-    circuit: Circuit, subcircuits: list[_Subcircuit]
+    circuit: Circuit,
+    subcircuits: list[_Subcircuit],
+    *,
+    odc_levels: int = 0,
+    simulation: tp.Optional[dict[Label, int]] = None,
+    epoch: int = 0,
 ) -> list[_Subcircuit]:
     """
-    Evaluate subcircuits truth table with don't cares.
+    Evaluate subcircuits truth table with don't cares: satisfiability don't cares
+    (assignments of subcircuit inputs which never occur) and, if `odc_levels` is
+    positive, observability don't cares (values of subcircuit outputs which do not
+    affect the circuit, see `_eval_observability_dont_cares`).
 
     :param circuit: given circuit.
     :param subcircuits: subcircuits for don't cares evaluation.
+    :param odc_levels: maximum distance of resimulated gates from subcircuit outputs
+        during observability don't cares evaluation, 0 disables them.
+    :param simulation: patterns of circuit gates, evaluated if not given.
+    :param epoch: number of replacements made in the circuit so far, it is stored in
+        subcircuits to detect that their don't cares are outdated.
     :return: list with updated subcircuits.
 
     """
-    inputs: list[Label] = circuit.inputs
-    assignment: dict[Label, GateState] = {input: False for input in inputs}
-    truth_table: dict[Label, list[int]] = collections.defaultdict(list)
-
-    for i in range(1 << len(inputs)):
-        if i:  # update assignment for new iteration
-            idx: int = len(inputs) - 1
-            while assignment[inputs[idx]]:
-                assignment[inputs[idx]] = False
-                idx -= 1
-            assignment[inputs[idx]] = True
-        for gate, value in circuit.evaluate_circuit(assignment).items():
-            if value != Undefined:
-                truth_table[gate].append(int(tp.cast(bool, value)))
+    if simulation is None:
+        simulation = _simulate_circuit(circuit)
+    number_of_assignments: int = 1 << len(circuit.inputs)
 
     for subcircuit in subcircuits:
-        possible_assignments: set[str] = set()
-        for i in range(1 << len(inputs)):
-            curr_assignment: list[str] = list()
-            for input in subcircuit.inputs:
-                curr_assignment.append(str(truth_table[input][i]))
-            possible_assignments.add(''.join(curr_assignment))
-        subcircuit.inputs_tt = sorted(possible_assignments)
+        n: int = len(subcircuit.inputs)
+        rows: list[int] = [0] * number_of_assignments
+        for j, input in enumerate(subcircuit.inputs):
+            pattern: int = simulation[input]
+            for i in range(number_of_assignments):
+                rows[i] |= ((pattern >> i) & 1) << (n - 1 - j)
+        subcircuit.inputs_tt = sorted(
+            {format(row, f'0{n}b') for row in rows}
+        )
+
+        subcircuit.dont_cares_epoch = epoch
+        subcircuit.odc = {}
+        if odc_levels <= 0:
+            continue
+        for output, dont_cares in _eval_observability_dont_cares(
+            circuit, subcircuit, simulation, odc_levels
+        ).items():
+            observable_rows: set[int] = {
+                row for i, row in enumerate(rows) if not (dont_cares >> i) & 1
+            }
+            subcircuit.odc[output] = sum(
+                1 << row for row in set(rows) - observable_rows
+            )
+
+        # Outputs with equal or opposite patterns are computed by the same gate of
+        # the new subcircuit (see `minimize_subcircuits`), so they can be changed
+        # only on rows where none of them is observable.
+        max_pattern: int = (1 << (1 << n)) - 1
+        odc: dict[Label, int] = subcircuit.odc
+        subcircuit.odc = {}
+        for output in odc:
+            pattern = subcircuit.patterns[output]
+            subcircuit.odc[output] = functools.reduce(
+                operator.and_,
+                (
+                    odc[other]
+                    for other in odc
+                    if subcircuit.patterns[other] in (pattern, max_pattern ^ pattern)
+                ),
+            )
     return subcircuits
 
 
+def _essential_inputs(table: list[tp.Any]) -> set[int]:
+    """
+    Get inputs on which any completion of partially defined truth table depends, i.e.
+    inputs for which there are two defined rows that differ only in this input but have
+    different values.
+
+    :param table: truth table of a single output (may contain don't cares).
+    :return: set of essential input positions (bit positions of row index).
+
+    """
+    essential: set[int] = set()
+    number_of_inputs: int = len(table).bit_length() - 1
+    for j in range(number_of_inputs):
+        bit = 1 << j
+        for t in range(len(table)):
+            if t & bit:
+                continue
+            a, b = table[t], table[t | bit]
+            if a != DontCare and b != DontCare and a != b:
+                essential.add(j)
+                break
+    return essential
+
+
+def _is_compatible(lhs: list[tp.Any], rhs: list[tp.Any], *, negate: bool) -> bool:
+    """
+    :return: True iff two partially defined truth tables have a common completion (up
+        to negation of `rhs` if `negate` is True).
+
+    """
+    return all(
+        a == DontCare or b == DontCare or (a != b if negate else a == b)
+        for a, b in zip(lhs, rhs)
+    )
+
+
+def _estimate_lower_bound(
+    subcircuit: _Subcircuit,
+    truth_table: RawTruthTableModel,
+    circuit_db: tp.Optional[CircuitsDatabase] = None,
+) -> int:
+    """
+    Estimate minimum number of (not NOT) gates required to compute outputs of the
+    subcircuit. Without database the estimation is a lower bound based on:
+
+    1. number of pairwise different non-trivial outputs (each requires own gate),
+    2. number of essential inputs of each output (function of `k` essential inputs
+       requires at least `k - 1` binary gates),
+    3. number of essential inputs of all non-trivial outputs (each gate merges at
+       most two connected components of the circuit).
+
+    If `circuit_db` is given and contains subcircuit's function, size of the stored
+    circuit is used instead.
+
+    :param subcircuit: subcircuit to be estimated.
+    :param truth_table: truth table of subcircuit outputs with don't cares.
+    :param circuit_db: optional database of small circuits in the target basis.
+    :return: estimated size of minimum subcircuit.
+
+    """
+    n: int = len(subcircuit.inputs)
+    literals: list[list[tp.Any]] = [[False] * (1 << n)]
+    for j in range(n):
+        literals.append([bool((t >> j) & 1) for t in range(1 << n)])
+
+    nontrivial: list[list[tp.Any]] = []
+    for table in truth_table:
+        if not any(
+            _is_compatible(table, literal, negate=negate)
+            for literal in literals
+            for negate in (False, True)
+        ):
+            nontrivial.append(table)
+
+    if not nontrivial:
+        return 0
+
+    distinct: list[list[tp.Any]] = []
+    for table in nontrivial:
+        if not any(
+            _is_compatible(table, other, negate=negate)
+            for other in distinct
+            for negate in (False, True)
+        ):
+            distinct.append(table)
+
+    supports: list[set[int]] = [_essential_inputs(table) for table in nontrivial]
+    lower_bound: int = max(
+        len(distinct),
+        max(len(support) - 1 for support in supports),
+        len(set().union(*supports)) - len(nontrivial),
+    )
+
+    if circuit_db is not None:
+        dont_cares: int = sum(row.count(DontCare) for row in nontrivial)
+        if dont_cares <= _DB_LOOKUP_MAX_DONT_CARES:
+            db_circuit: tp.Optional[Circuit] = circuit_db.get_by_raw_truth_table_model(
+                nontrivial
+            )
+            if db_circuit is not None:
+                return db_circuit.gates_number()
+
+    return lower_bound
+
+
+def _rank_subcircuits(
+    subcircuits: list[_Subcircuit],
+    circuit_db: tp.Optional[CircuitsDatabase] = None,
+) -> list[_Subcircuit]:
+    """
+    Prioritize subcircuits for simplification. Subcircuits which already appear
+    optimal (estimated gain is not positive) are skipped, the remaining ones are sorted
+    by decreasing of estimated gain (and by increasing size on tie, because smaller
+    subcircuits are cheaper to solve).
+
+    Must be called after don't cares are evaluated (see `_eval_dont_cares`).
+
+    :param subcircuits: subcircuits for ranking.
+    :param circuit_db: optional database of small circuits in the target basis.
+    :return: prioritized list of subcircuits.
+
+    """
+    for subcircuit in subcircuits:
+        subcircuit.lower_bound = _estimate_lower_bound(
+            subcircuit,
+            subcircuit.evaluate_truth_table_with_dont_cares(),
+            circuit_db,
+        )
+
+    ranked: list[_Subcircuit] = [
+        subcircuit for subcircuit in subcircuits if subcircuit.gain > 0
+    ]
+    logger.debug(f"Skipped {len(subcircuits) - len(ranked)} optimal subcircuits")
+
+    ranked.sort(key=lambda x: (-x.gain, x.size))
+    return ranked
+
+
 def _get_internal_gates(
     circuit: "Circuit",
     inputs: list[Label],
@@ -402,14 +774,21 @@ def minimize_subcircuits(
     cut_size: int = 5,
     cut_limit: int = 25,
     fanout_size: int = 10000,
+    circuit_db: tp.Optional[CircuitsDatabase] = None,
+    window_inputs: int = 0,
+    window_outputs: int = 3,
+    odc_levels: int = 0,
 ) -> Circuit:
     """
     Improve circuit's size by simplification its subcircuits using SAT-Solver.
     The algorithm is following:
-    1. Get all limited size cuts.
-    2. Remove nested cuts and build subcircuits on the remaining.
-    3. Evaluate truth tables for subcircuits with don't cares.
-    4. Try to improve found subcircuits using SAT-Solver for finding lower size circuit.
+    1. Get all limited size cuts (and reconvergence-driven windows if enabled).
+    2. Remove nested cuts and build subcircuits on the remaining cuts and windows.
+    3. Evaluate truth tables for subcircuits with don't cares (satisfiability and,
+       if enabled, observability ones).
+    4. Estimate possible gain of each subcircuit, skip ones which appear optimal
+       and order the rest by decreasing gain.
+    5. Try to improve found subcircuits using SAT-Solver for finding lower size circuit.
 
     Note: this method prefers not to have equivalent gates in the circuit.
     It's better to detect and simplify them before applying this function.
@@ -426,9 +805,18 @@ def minimize_subcircuits(
     :param cut_size: [mockturtle params] Maximum number of leaves for a cut.
     :param cut_limit: [mockturtle params] Maximum number of cuts for a node.
     :param fanin_limit: [mockturtle params] Maximum number of fan-ins for a node.
+    :param circuit_db: database of small circuits in the `basis`. If given, it is
+        used to estimate the optimal size of subcircuits, otherwise lower bound based
+        on the number of essential inputs is used.
+    :param window_inputs: [windowing params] Maximum number of inputs of
+        reconvergence-driven windows, which are considered in addition to cuts and may
+        be larger than `cut_size`. Windows are not used if 0. Number of window gates
+        is limited by `max_subcircuit_size`.
+    :param window_outputs: [windowing params] Maximum number of outputs of a window.
+    :param odc_levels: maximum distance from subcircuit outputs of gates which are
+        resimulated to find values of outputs which are not observable. Observability
+        don't cares are not used if 0.
     :return: simplified circuit.
-    :raises UnsupportedOperationError: If circuit has unsupported operation for
-        minimization algorithm.
     :raises FailedValidationError: If minimized circuit is not equivalent to initial
         circuit.
 
@@ -453,10 +841,35 @@ def minimize_subcircuits(
     subcircuits: list[_Subcircuit] = _get_subcircuits(
         circuit, cuts, cut_nodes, max_subcircuit_size, cut_size
     )
-    subcircuits = _eval_dont_cares(circuit, subcircuits)
+    if window_inputs > 0:
+        known_gates: set[frozenset[Label]] = {
+            frozenset(subcircuit.gates) for subcircuit in subcircuits
+        }
+        for window in _get_windows(
+            circuit,
+            mw.enumerate_windows(
+                circuit.format_circuit(),
+                window_inputs,
+                max_subcircuit_size,
+                window_outputs,
+            ),
+        ):
+            if frozenset(window.gates) not in known_gates:
+                known_gates.add(frozenset(window.gates))
+                subcircuits.append(window)
+    simulation: tp.Optional[dict[Label, int]] = _simulate_circuit(circuit)
+    subcircuits = _eval_dont_cares(
+        circuit, subcircuits, odc_levels=odc_levels, simulation=simulation
+    )
+    subcircuits = _rank_subcircuits(subcircuits, circuit_db)
     node_states: dict[Label, _NodeState] = {
         label: _NodeState.UNCHANGED for label in circuit.gates
     }
+    # Number of replacements made while observability don't cares are enabled. Such
+    # replacement changes functions of gates on don't care rows, which can make
+    # don't cares of any other subcircuit invalid, so they are reevaluated once the
+    # subcircuit is taken for processing.
+    epoch: int = 0
 
     for iter, subcircuit in enumerate(subcircuits):
         inputs: list[Label] = subcircuit.inputs
@@ -468,8 +881,12 @@ def minimize_subcircuits(
 
         skip_subcircuit: bool = False
         for gate in subcircuit.gates:
-            if node_states[gate] == _NodeState.REMOVED or (
-                node_states[gate] == _NodeState.MODIFIED and gate not in inputs_set
+            if (
+                not circuit.has_gate(gate)
+                or node_states[gate] == _NodeState.REMOVED
+                or (
+                    node_states[gate] == _NodeState.MODIFIED and gate not in inputs_set
+                )
             ):
                 skip_subcircuit = True
                 break
@@ -517,11 +934,25 @@ def minimize_subcircuits(
                 circuit._outputs = [
                     new_output if x == output else x for x in circuit._outputs
                 ]
+                circuit._mark_modified()
                 circuit.remove_gate(output)
                 node_states[output] = _NodeState.REMOVED
                 node_states[new_output] = _NodeState.REMOVED
+            if odc_levels > 0:
+                epoch += 1
+                simulation = None
             continue
 
+        if subcircuit.dont_cares_epoch != epoch:
+            if simulation is None:
+                simulation = _simulate_circuit(circuit)
+            _eval_dont_cares(
+                circuit,
+                [subcircuit],
+                odc_levels=odc_levels,
+                simulation=simulation,
+                epoch=epoch,
+            )
         outputs_tt: RawTruthTableModel = [
             row
             for i, row in enumerate(subcircuit.evaluate_truth_table_with_dont_cares())
@@ -532,7 +963,10 @@ def minimize_subcircuits(
                 TruthTableModel(outputs_tt),
                 size - 1,
                 basis=_basis,
-            ).find_circuit(time_limit=solver_time_limit_sec)
+            ).find_circuit(
+                time_limit=solver_time_limit_sec,
+                cegis=len(inputs) >= _CEGIS_MIN_INPUTS,
+            )
         except NoSolutionError:
             logger.debug("Smaller subcircuit not found")
             continue
@@ -579,6 +1013,9 @@ def minimize_subcircuits(
 
         circuit = new_circuit
         logger.debug("Improved circuit size")
+        if odc_levels > 0:
+            epoch += 1
+            simulation = None
 
         # Update the states
         for output in output_labels_mapping:
@@ -3,7 +3,9 @@ execution, reduction of Circuit SAT to SAT and building miter circuits, which ar
 helpful for circuit equivalence checking using."""
 
 from .cnf import Cnf, tseytin_transformation
+from .counting import count_models, count_satisfying_assignments
 from .miter import build_miter
+from .preprocessing import PreprocessedFormula, preprocess, PreprocessingStats
 from .sat import is_circuit_satisfiable, is_satisfiable, PySatResult, PySATSolverNames
 
 
@@ -11,8 +13,15 @@ __all__ = [
     # cnf.py
     'Cnf',
     'tseytin_transformation',
+    # counting.py
+    'count_satisfying_assignments',
+    'count_models',
     # miter.py
     'build_miter',
+    # preprocessing.py
+    'preprocess',
+    'PreprocessedFormula',
+    'PreprocessingStats',
     # sat.py
     'is_satisfiable',
     'is_circuit_satisfiable',
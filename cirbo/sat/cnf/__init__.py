@@ -1,11 +1,18 @@
+from .cardinality import at_most_one, AtMostOneEncoding, exactly_one
 from .cnf import Clause, Cnf, CnfRaw, Lit
-from .tseytin import tseytin_transformation
+from .plaisted_greenbaum import plaisted_greenbaum_transformation
+from .tseytin import hierarchical_tseytin_transformation, tseytin_transformation
 
 
 __all__ = [
+    'AtMostOneEncoding',
+    'at_most_one',
+    'exactly_one',
     'Lit',
     'Clause',
     'CnfRaw',
     'Cnf',
     'tseytin_transformation',
+    'hierarchical_tseytin_transformation',
+    'plaisted_greenbaum_transformation',
 ]
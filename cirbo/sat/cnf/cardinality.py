@@ -0,0 +1,139 @@
+"""
+Module contains CNF encodings of the "at most one" and "exactly one" cardinality
+constraints. Besides the naive pairwise encoding, which needs quadratic number of
+clauses, encodings with auxiliary variables and linear (or almost linear) number of
+clauses are provided.
+
+"""
+
+import enum
+import itertools
+import math
+import typing as tp
+
+from .cnf import CnfRaw, Lit
+
+
+__all__ = [
+    'AtMostOneEncoding',
+    'at_most_one',
+    'exactly_one',
+]
+
+
+class AtMostOneEncoding(enum.Enum):
+    """CNF encodings of the "at most one" constraint over `n` literals."""
+
+    # Clause for every pair of literals: n(n-1)/2 clauses, no auxiliary variables.
+    PAIRWISE = 'PAIRWISE'
+    # Sinz sequential counter: 3n-4 clauses, n-1 auxiliary variables.
+    SEQUENTIAL_COUNTER = 'SEQUENTIAL_COUNTER'
+    # Klieber-Kwon commander encoding with groups of three literals:
+    # about 3.5n clauses, about n/2 auxiliary variables.
+    COMMANDER = 'COMMANDER'
+    # Chen product encoding: about 2n + 4 sqrt(n) clauses, about 2 sqrt(n)
+    # auxiliary variables.
+    PRODUCT = 'PRODUCT'
+
+
+# Constraints over at most this number of literals are always encoded pairwise, since
+# for them it produces the smallest formula.
+_PAIRWISE_THRESHOLD = 4
+
+# Size of a group of the commander encoding.
+_COMMANDER_GROUP_SIZE = 3
+
+
+def at_most_one(
+    literals: tp.Sequence[Lit],
+    new_variable: tp.Callable[[], int],
+    encoding: tp.Union[AtMostOneEncoding, str] = AtMostOneEncoding.PAIRWISE,
+) -> CnfRaw:
+    """
+    Encodes the constraint that at most one of the given literals is true.
+
+    :param literals: literals of the constraint.
+    :param new_variable: function returning a new unused variable, it's called for
+        each auxiliary variable of the encoding.
+    :param encoding: encoding to be used.
+    :return: clauses of the encoding.
+
+    """
+    encoding = AtMostOneEncoding(encoding)
+    literals = list(literals)
+    if len(literals) <= _PAIRWISE_THRESHOLD or encoding == AtMostOneEncoding.PAIRWISE:
+        return _pairwise(literals)
+    if encoding == AtMostOneEncoding.SEQUENTIAL_COUNTER:
+        return _sequential_counter(literals, new_variable)
+    if encoding == AtMostOneEncoding.COMMANDER:
+        return _commander(literals, new_variable)
+    return _product(literals, new_variable)
+
+
+def exactly_one(
+    literals: tp.Sequence[Lit],
+    new_variable: tp.Callable[[], int],
+    encoding: tp.Union[AtMostOneEncoding, str] = AtMostOneEncoding.PAIRWISE,
+) -> CnfRaw:
+    """
+    Encodes the constraint that exactly one of the given literals is true.
+
+    :param literals: literals of the constraint.
+    :param new_variable: function returning a new unused variable, it's called for
+        each auxiliary variable of the encoding.
+    :param encoding: encoding of the "at most one" part of the constraint.
+    :return: clauses of the encoding.
+
+    """
+    return [list(literals)] + at_most_one(literals, new_variable, encoding)
+
+
+def _pairwise(literals: list[Lit]) -> CnfRaw:
+    return [[-a, -b] for a, b in itertools.combinations(literals, 2)]
+
+
+def _sequential_counter(
+    literals: list[Lit],
+    new_variable: tp.Callable[[], int],
+) -> CnfRaw:
+    # s_i is true iff some of the first i + 1 literals is true.
+    n = len(literals)
+    s = [new_variable() for _ in range(n - 1)]
+    clauses = [[-literals[0], s[0]]]
+    for i in range(1, n - 1):
+        clauses.append([-literals[i], s[i]])
+        clauses.append([-s[i - 1], s[i]])
+        clauses.append([-literals[i], -s[i - 1]])
+    clauses.append([-literals[n - 1], -s[n - 2]])
+    return clauses
+
+
+def _commander(literals: list[Lit], new_variable: tp.Callable[[], int]) -> CnfRaw:
+    # Commander of a group is implied by any literal of the group, so at most one
+    # commander may be true.
+    clauses: CnfRaw = []
+    commanders: list[Lit] = []
+    for start in range(0, len(literals), _COMMANDER_GROUP_SIZE):
+        group = literals[start : start + _COMMANDER_GROUP_SIZE]
+        commander = new_variable()
+        commanders.append(commander)
+        clauses.extend(_pairwise(group))
+        clauses.extend([-literal, commander] for literal in group)
+    clauses.extend(at_most_one(commanders, new_variable, AtMostOneEncoding.COMMANDER))
+    return clauses
+
+
+def _product(literals: list[Lit], new_variable: tp.Callable[[], int]) -> CnfRaw:
+    # Literals are placed into a grid, each literal implies variables of its row and
+    # of its column, and at most one row and at most one column may be selected.
+    rows_number = math.ceil(math.sqrt(len(literals)))
+    columns_number = math.ceil(len(literals) / rows_number)
+    rows = [new_variable() for _ in range(rows_number)]
+    columns = [new_variable() for _ in range(columns_number)]
+    clauses: CnfRaw = []
+    for i, literal in enumerate(literals):
+        clauses.append([-literal, rows[i // columns_number]])
+        clauses.append([-literal, columns[i % columns_number]])
+    clauses.extend(at_most_one(rows, new_variable, AtMostOneEncoding.PRODUCT))
+    clauses.extend(at_most_one(columns, new_variable, AtMostOneEncoding.PRODUCT))
+    return clauses
@@ -1,3 +1,5 @@
+import array
+import itertools
 import typing as tp
 
 from cirbo.core.circuit import Circuit
@@ -10,41 +12,144 @@ Lit = int
 Clause = list[Lit]
 CnfRaw = list[Clause]
 
+# Number of clauses written to a DIMACS file at once.
+_DIMACS_CHUNK_SIZE = 1 << 14
+
 
 class Cnf:
-    """Structure to store CNF formula."""
+    """
+    Structure to store CNF formula.
+
+    Literals of all clauses are stored in a single flat buffer of 32-bit integers
+    together with offsets of clauses in this buffer, which takes several times less
+    memory than a list of lists. Clauses are materialized as lists one at a time, when
+    the formula is iterated over (e.g. by `pysat` solver in `append_formula`).
+
+    """
 
     @staticmethod
-    def from_circuit(circuit: Circuit) -> 'Cnf':
+    def from_circuit(circuit: Circuit, *, polarity_aware: bool = False) -> 'Cnf':
         """
         Converts circuit to CNF by Tseytin transformation and returns CNF.
 
         :param circuit: Circuit what will be converted to cnf.
+        :param polarity_aware: if True, polarity-aware simplifying transformation is
+            used instead (see `plaisted_greenbaum_transformation`), which produces
+            smaller formula, but values of non-input variables in its models may be
+            inconsistent with the circuit.
 
         """
+        if polarity_aware:
+            from cirbo.sat.cnf.plaisted_greenbaum import (
+                plaisted_greenbaum_transformation,
+            )
+
+            return plaisted_greenbaum_transformation(circuit)
+
         from cirbo.sat.cnf.tseytin import tseytin_transformation
 
         return tseytin_transformation(circuit)
 
-    def __init__(self, cnf: tp.Optional[CnfRaw] = None):
+    def __init__(self, cnf: tp.Optional[tp.Iterable[tp.Iterable[Lit]]] = None):
         """
 
         :param cnf: CNF can be not assigned, it means cnf is empty.
         """
-        if cnf is None:
-            self._cnf = []
-        else:
-            self._cnf = cnf
-
-    def add_clause(self, clause: Clause):
+        self._literals = array.array('i')
+        # Clause `i` consists of literals from `_offsets[i]` to `_offsets[i + 1]`.
+        self._offsets = array.array('q', [0])
+        self._number_of_variables = 0
+        if cnf is not None:
+            self.extend(cnf)
+
+    def add_clause(self, clause: tp.Iterable[Lit]):
         """
         Add clause to CNF.
 
         :param clause: new clause.
 
         """
-        self._cnf.append(clause)
+        self._literals.extend(clause)
+        start = self._offsets[-1]
+        if len(self._literals) > start:
+            self._number_of_variables = max(
+                self._number_of_variables,
+                max(map(abs, self._literals[start:])),
+            )
+        self._offsets.append(len(self._literals))
+
+    def extend(self, clauses: tp.Iterable[tp.Iterable[Lit]]):
+        """
+        Add several clauses to CNF.
+
+        :param clauses: new clauses.
+
+        """
+        for clause in clauses:
+            self.add_clause(clause)
+
+    @property
+    def number_of_variables(self) -> int:
+        """
+        :return: maximum variable occurring in the formula.
+
+        """
+        return self._number_of_variables
+
+    @property
+    def literals(self) -> memoryview:
+        """
+        :return: read-only view of the flat buffer of literals of all clauses.
+
+        """
+        return memoryview(self._literals).toreadonly()
+
+    @property
+    def offsets(self) -> memoryview:
+        """
+        :return: read-only view of the offsets of clauses in the buffer of literals,
+            clause `i` occupies positions from `offsets[i]` to `offsets[i + 1]`.
+
+        """
+        return memoryview(self._offsets).toreadonly()
+
+    def __len__(self) -> int:
+        return len(self._offsets) - 1
+
+    def __iter__(self) -> tp.Iterator[Clause]:
+        literals, offsets = self._literals, self._offsets
+        for i in range(len(offsets) - 1):
+            yield literals[offsets[i] : offsets[i + 1]].tolist()
+
+    def __getitem__(self, index: int) -> Clause:
+        if index < 0:
+            index += len(self)
+        if not 0 <= index < len(self):
+            raise IndexError("Clause index out of range.")
+        return self._literals[self._offsets[index] : self._offsets[index + 1]].tolist()
+
+    def write_dimacs(self, file: tp.TextIO) -> None:
+        """
+        Writes formula in DIMACS format. Formula is written in chunks, so no string
+        representation of the whole formula is built.
+
+        :param file: text stream to write to.
+
+        """
+        file.write(f'p cnf {self._number_of_variables} {len(self)}\n')
+        clauses = iter(self)
+        while chunk := list(itertools.islice(clauses, _DIMACS_CHUNK_SIZE)):
+            file.write(
+                ''.join(
+                    ' '.join(map(str, clause)) + (' 0\n' if clause else '0\n')
+                    for clause in chunk
+                )
+            )
 
     def get_raw(self) -> CnfRaw:
-        """Returns CnfRaw object."""
-        return self._cnf
+        """
+        Returns CnfRaw object. It's built on each call, so iterating over `Cnf`
+        directly should be preferred for large formulas.
+
+        """
+        return list(self)
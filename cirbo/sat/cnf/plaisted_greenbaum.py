@@ -0,0 +1,334 @@
+"""
+Module contains polarity-aware (Plaisted-Greenbaum) transformation of a circuit into
+CNF, which simplifies the circuit on the way: NOT and IFF gates are folded into signs
+of literals, constants are propagated, AND/OR trees are merged into multi-input gates
+and structurally equal gates share a variable.
+
+"""
+
+import typing as tp
+
+from cirbo.core.circuit import (
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+    AND,
+    Circuit,
+    GEQ,
+    GT,
+    IFF,
+    INPUT,
+    Label,
+    LEQ,
+    LIFF,
+    LNOT,
+    LT,
+    NAND,
+    NOR,
+    NOT,
+    NXOR,
+    OR,
+    RIFF,
+    RNOT,
+    XOR,
+)
+from cirbo.sat.cnf.cnf import Cnf, Lit
+
+
+__all__ = ['plaisted_greenbaum_transformation']
+
+
+# Signal of a simplified circuit: either a literal or a constant.
+_Signal = tp.Union[Lit, bool]
+
+# Polarities in which a variable is used: it's required that the variable implies
+# (POSITIVE) or is implied by (NEGATIVE) its definition.
+_POSITIVE = 1
+_NEGATIVE = 2
+
+
+def plaisted_greenbaum_transformation(
+    circuit: Circuit,
+    outputs: tp.Optional[list[int]] = None,
+) -> Cnf:
+    """
+    Converts circuit to CNF which is satisfiable iff some assignment of inputs makes
+    all the given outputs true.
+
+    Unlike Tseytin transformation, a gate definition is encoded only in directions
+    required by polarities in which the gate is used: e.g. if an AND gate is used only
+    positively, clauses stating that it's true whenever its operands are true are
+    omitted. Besides:
+      - NOT, IFF and their left/right versions don't get variables, but flip the sign of
+        their operand literal;
+      - constants are propagated through gates;
+      - AND (OR) gates, whose operands are AND (OR) gates used once, are merged into
+        one multi-input gate;
+      - structurally equal AND and XOR gates share a variable.
+
+    Variables of inputs are numbered from 1 in order of circuit inputs, so the values
+    of inputs in a model of the formula is a satisfying assignment of the circuit.
+    Values of other variables may not be consistent with the circuit.
+
+    :param circuit: circuit to be converted.
+    :param outputs: indices of outputs which should be true, all outputs by default.
+    :return: CNF formula.
+
+    """
+    return _Encoder(circuit).encode(
+        list(range(circuit.output_size)) if outputs is None else outputs
+    )
+
+
+def _negate(signal: _Signal) -> _Signal:
+    if isinstance(signal, bool):
+        return not signal
+    return -signal
+
+
+class _Encoder:
+    def __init__(self, circuit: Circuit):
+        self._circuit = circuit
+        self._next_variable = 0
+        self._signals: dict[Label, _Signal] = {}
+        # Definitions of gate variables: AND of literals or XOR of two literals.
+        self._definitions: dict[int, tuple[bool, tuple[Lit, ...]]] = {}
+        self._structural_hash: dict[tuple[bool, tuple[Lit, ...]], int] = {}
+        self._uses: dict[int, int] = {}
+
+    def encode(self, outputs: list[int]) -> Cnf:
+        for label in self._circuit.inputs:
+            self._signals[label] = self._new_variable()
+
+        output_labels = [self._circuit.output_at_index(i) for i in outputs]
+        for label in self._post_order(output_labels):
+            self._signals[label] = self._process_gate(label)
+
+        cnf = Cnf()
+        polarity: dict[int, int] = {}
+        for label in output_labels:
+            signal = self._signals[label]
+            if isinstance(signal, bool):
+                if not signal:
+                    cnf.add_clause([])
+                continue
+            cnf.add_clause([signal])
+            self._require(polarity, signal, _POSITIVE)
+
+        # Variables are created in topological order, so users of each variable are
+        # processed before it.
+        for variable in range(self._next_variable, 0, -1):
+            if variable not in polarity or variable not in self._definitions:
+                continue
+            is_xor, operands = self._definitions[variable]
+            if is_xor:
+                self._encode_xor(cnf, polarity, variable, operands)
+            else:
+                self._encode_and(cnf, polarity, variable, operands)
+        return self._renumber(cnf, polarity)
+
+    def _renumber(self, cnf: Cnf, polarity: dict[int, int]) -> Cnf:
+        """
+        :return: formula with variables of gates, which were merged into other gates
+            or not used at all, excluded from numbering. Inputs keep their variables.
+
+        """
+        number_of_inputs = len(self._circuit.inputs)
+        mapping = list(range(number_of_inputs + 1))
+        number_of_variables = number_of_inputs
+        for variable in range(number_of_inputs + 1, self._next_variable + 1):
+            if variable in polarity:
+                number_of_variables += 1
+            mapping.append(number_of_variables)
+        if number_of_variables == self._next_variable:
+            return cnf
+
+        result = Cnf()
+        for clause in cnf:
+            result.add_clause(
+                mapping[literal] if literal > 0 else -mapping[-literal]
+                for literal in clause
+            )
+        return result
+
+    def _post_order(self, start: list[Label]) -> list[Label]:
+        """
+        :return: labels of non-input gates reachable from the given gates in DFS
+            post-order, which is a topological order.
+
+        """
+        order: list[Label] = []
+        visited: set[Label] = set(self._signals)
+        for label in start:
+            if label in visited:
+                continue
+            visited.add(label)
+            stack: list[tuple[Label, int]] = [(label, 0)]
+            while stack:
+                label, position = stack.pop()
+                operands = self._circuit.get_gate(label).operands
+                if position < len(operands):
+                    stack.append((label, position + 1))
+                    if operands[position] not in visited:
+                        visited.add(operands[position])
+                        stack.append((operands[position], 0))
+                else:
+                    order.append(label)
+        return order
+
+    def _process_gate(self, label: Label) -> _Signal:
+        _gate = self._circuit.get_gate(label)
+        gate_type = _gate.gate_type
+        ops = [self._signals[operand] for operand in _gate.operands]
+
+        if gate_type == INPUT:
+            return self._new_variable()
+        if gate_type == ALWAYS_TRUE:
+            return True
+        if gate_type == ALWAYS_FALSE:
+            return False
+        if gate_type in (NOT, LNOT):
+            return _negate(ops[0])
+        if gate_type == RNOT:
+            return _negate(ops[1])
+        if gate_type in (IFF, LIFF):
+            return ops[0]
+        if gate_type == RIFF:
+            return ops[1]
+        if gate_type == AND:
+            return self._and(ops)
+        if gate_type == NAND:
+            return _negate(self._and(ops))
+        if gate_type == OR:
+            return _negate(self._and([_negate(op) for op in ops]))
+        if gate_type == NOR:
+            return self._and([_negate(op) for op in ops])
+        if gate_type == GT:
+            return self._and([ops[0], _negate(ops[1])])
+        if gate_type == LT:
+            return self._and([_negate(ops[0]), ops[1]])
+        if gate_type == GEQ:
+            return _negate(self._and([_negate(ops[0]), ops[1]]))
+        if gate_type == LEQ:
+            return _negate(self._and([ops[0], _negate(ops[1])]))
+        if gate_type == XOR:
+            return self._xor(ops)
+        if gate_type == NXOR:
+            return _negate(self._xor(ops))
+        raise ValueError(f"Unsupported gate type: {gate_type}.")
+
+    def _new_variable(self) -> int:
+        self._next_variable += 1
+        return self._next_variable
+
+    def _and(self, ops: list[_Signal]) -> _Signal:
+        literals: set[Lit] = set()
+        for op in ops:
+            if op is False:
+                return False
+            if op is True:
+                continue
+            if -op in literals:
+                return False
+            literals.add(op)
+        if not literals:
+            return True
+        if len(literals) == 1:
+            return next(iter(literals))
+        return self._define(False, tuple(sorted(literals)))
+
+    def _xor(self, ops: list[_Signal]) -> _Signal:
+        # Literals occurring odd number of times, up to sign.
+        literals: set[Lit] = set()
+        inverted = False
+        for op in ops:
+            if isinstance(op, bool):
+                inverted ^= op
+                continue
+            if op < 0:
+                inverted, op = not inverted, -op
+            literals ^= {op}
+
+        result: _Signal = False
+        for literal in sorted(literals):
+            if result is False:
+                result = literal
+                continue
+            assert not isinstance(result, bool)
+            if result < 0:
+                inverted, result = not inverted, -result
+            result = self._define(True, tuple(sorted((result, literal))))
+        return _negate(result) if inverted else result
+
+    def _define(self, is_xor: bool, operands: tuple[Lit, ...]) -> int:
+        key = (is_xor, operands)
+        if key in self._structural_hash:
+            variable = self._structural_hash[key]
+        else:
+            variable = self._new_variable()
+            self._structural_hash[key] = variable
+            self._definitions[variable] = key
+            for operand in operands:
+                self._uses[abs(operand)] = self._uses.get(abs(operand), 0) + 1
+        return variable
+
+    def _require(self, polarity: dict[int, int], literal: Lit, required: int) -> None:
+        if literal < 0:
+            required = (_POSITIVE if required & _NEGATIVE else 0) | (
+                _NEGATIVE if required & _POSITIVE else 0
+            )
+        variable = abs(literal)
+        polarity[variable] = polarity.get(variable, 0) | required
+
+    def _and_operands(self, operands: tp.Iterable[Lit]) -> list[Lit]:
+        """
+        :return: operands of AND gate with operands being AND gates used only by this
+            gate replaced by their operands.
+
+        """
+        result: list[Lit] = []
+        stack = list(operands)
+        while stack:
+            literal = stack.pop()
+            definition = self._definitions.get(literal)
+            is_and = definition is not None and not definition[0]
+            if is_and and self._uses[literal] == 1:
+                assert definition is not None
+                stack.extend(definition[1])
+            else:
+                result.append(literal)
+        return result
+
+    def _encode_and(
+        self,
+        cnf: Cnf,
+        polarity: dict[int, int],
+        variable: int,
+        operands: tuple[Lit, ...],
+    ) -> None:
+        required = polarity[variable]
+        literals = self._and_operands(operands)
+        if required & _POSITIVE:
+            for literal in literals:
+                cnf.add_clause([-variable, literal])
+        if required & _NEGATIVE:
+            cnf.add_clause([variable] + [-literal for literal in literals])
+        for literal in literals:
+            self._require(polarity, literal, required)
+
+    def _encode_xor(
+        self,
+        cnf: Cnf,
+        polarity: dict[int, int],
+        variable: int,
+        operands: tuple[Lit, ...],
+    ) -> None:
+        required = polarity[variable]
+        a, b = operands
+        if required & _POSITIVE:
+            cnf.add_clause([-variable, a, b])
+            cnf.add_clause([-variable, -a, -b])
+        if required & _NEGATIVE:
+            cnf.add_clause([variable, -a, b])
+            cnf.add_clause([variable, a, -b])
+        for literal in operands:
+            self._require(polarity, literal, _POSITIVE | _NEGATIVE)
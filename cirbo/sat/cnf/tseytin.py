@@ -6,11 +6,13 @@ from cirbo.core.circuit import (
     ALWAYS_TRUE,
     AND,
     Circuit,
+    Gate,
     GateType,
     GEQ,
     GT,
     IFF,
     INPUT,
+    Label,
     LEQ,
     LIFF,
     LNOT,
@@ -24,16 +26,114 @@ from cirbo.core.circuit import (
     RNOT,
     XOR,
 )
-from cirbo.sat.cnf.cnf import Cnf, CnfRaw, Lit
+from cirbo.core.circuit.hierarchy import HierarchicalCircuit, Instance
+from cirbo.sat.cnf.cnf import Cnf, Lit
 
 
-__all__ = ['tseytin_transformation']
+__all__ = ['tseytin_transformation', 'hierarchical_tseytin_transformation']
 
 
 def tseytin_transformation(
     circuit: Circuit,
     outputs: tp.Optional[list[int]] = None,
 ) -> Cnf:
+    if outputs is None:
+        outputs = list(range(circuit.output_size))
+    cnf, _ = _encode(circuit, outputs, assert_outputs=True)
+    return cnf
+
+
+def hierarchical_tseytin_transformation(
+    circuit: HierarchicalCircuit,
+    outputs: tp.Optional[list[int]] = None,
+) -> Cnf:
+    """
+    Converts hierarchical circuit to CNF which is satisfiable iff some assignment of
+    inputs makes all the given outputs true. Each definition is encoded once, and its
+    clauses are copied for each instance with renumbered variables, so the circuit is
+    never flattened.
+
+    Variables of inputs are numbered from 1 in order of circuit inputs.
+
+    :param circuit: circuit to be converted.
+    :param outputs: indices of outputs which should be true, all outputs by default.
+    :return: CNF formula.
+
+    """
+    if outputs is None:
+        outputs = list(range(circuit.output_size))
+    output_labels = [circuit.outputs[i] for i in outputs]
+
+    # Only nodes in the cone of the outputs are encoded.
+    required: set[Label] = set(output_labels)
+    nodes: list[tp.Union[Gate, Instance]] = []
+    for node in reversed(circuit.nodes):
+        if isinstance(node, Gate):
+            if node.label in required:
+                nodes.append(node)
+                required.update(node.operands)
+        elif required.intersection(node.outputs):
+            nodes.append(node)
+            required.update(node.inputs)
+    nodes.reverse()
+
+    lits: dict[Label, Lit] = {label: i + 1 for i, label in enumerate(circuit.inputs)}
+    next_lit = circuit.input_size
+    templates: dict[int, tuple[Cnf, list[Lit]]] = {}
+    cnf = Cnf()
+    for node in nodes:
+        if isinstance(node, Gate):
+            next_lit += 1
+            lits[node.label] = next_lit
+            _OPERATIONS[node.gate_type](
+                cnf, next_lit, [lits[operand] for operand in node.operands]
+            )
+            continue
+
+        node.check_definition()
+        definition = node.definition
+        if id(definition) not in templates:
+            templates[id(definition)] = _encode(
+                definition,
+                list(range(definition.output_size)),
+                assert_outputs=False,
+            )
+        template, output_lits = templates[id(definition)]
+        # Inputs of the definition are its first variables, the rest get new ones.
+        mapping = [0] + [lits[label] for label in node.inputs]
+        offset = next_lit - definition.input_size
+        next_lit = max(next_lit, offset + template.number_of_variables)
+
+        def _map(lit: Lit) -> Lit:
+            variable = abs(lit)
+            if variable < len(mapping):
+                variable = mapping[variable]
+            else:
+                variable += offset
+            return variable if lit > 0 else -variable
+
+        for clause in template:
+            cnf.add_clause([_map(lit) for lit in clause])
+        for label, lit in zip(node.outputs, output_lits):
+            lits.setdefault(label, _map(lit))
+
+    for label in output_labels:
+        cnf.add_clause([lits[label]])
+    return cnf
+
+
+def _encode(
+    circuit: Circuit,
+    outputs: list[int],
+    *,
+    assert_outputs: bool,
+) -> tuple[Cnf, list[Lit]]:
+    """
+    :return: Tseytin encoding of cone of the given outputs, where inputs are numbered
+        from 1 in order of circuit inputs, and literals of the outputs. If
+        `assert_outputs`, unit clauses stating that outputs are true are included.
+
+    """
     next_lit = 0
 
     def __register_new_gate() -> Lit:
@@ -49,31 +149,7 @@ def tseytin_transformation(
     for input_label in circuit.inputs:
         _ = saved_lits[input_label]
 
-    if outputs is None:
-        outputs = list(range(circuit.output_size))
-    cnf: CnfRaw = []
-
-    _operations: dict[GateType, tp.Callable[[CnfRaw, Lit, list[Lit]], None]] = {
-        INPUT: _process_input,
-        ALWAYS_TRUE: _process_always_true,
-        ALWAYS_FALSE: _process_always_false,
-        NOT: _process_not_or_lnot,
-        LNOT: _process_not_or_lnot,
-        RNOT: _process_rnot,
-        IFF: _process_iff_or_liff,
-        LIFF: _process_iff_or_liff,
-        RIFF: _process_riff,
-        AND: _process_and,
-        NAND: _process_nand,
-        OR: _process_or,
-        NOR: _process_nor,
-        XOR: _process_xor,
-        NXOR: _process_nxor,
-        GT: _process_gt,
-        LT: _process_lt,
-        GEQ: _process_geq,
-        LEQ: _process_leq,
-    }
+    cnf = Cnf()
 
     def process_gate(label: str) -> Lit:
         if label in saved_lits:
@@ -83,118 +159,144 @@ def tseytin_transformation(
         lits = [process_gate(lit) for lit in operands]
         gate_type = gate.gate_type
         top_lit = get_lit(label)
-        _operations[gate_type](cnf, top_lit, lits)
+        _OPERATIONS[gate_type](cnf, top_lit, lits)
         return top_lit
 
+    output_lits = []
     for output_index in outputs:
         output_lit = process_gate(circuit.output_at_index(output_index))
-        cnf.append([output_lit])
-    return Cnf(cnf)
+        output_lits.append(output_lit)
+        if assert_outputs:
+            cnf.add_clause([output_lit])
+    return cnf, output_lits
 
 
-def _process_input(_: CnfRaw, __: Lit, ___: list[Lit]):
+def _process_input(_: Cnf, __: Lit, ___: list[Lit]):
     pass
 
 
-def _process_always_true(cnf: CnfRaw, top_lit: Lit, _: list[Lit]):
-    cnf.append([top_lit])
+def _process_always_true(cnf: Cnf, top_lit: Lit, _: list[Lit]):
+    cnf.add_clause([top_lit])
 
 
-def _process_always_false(cnf: CnfRaw, top_lit: Lit, _: list[Lit]):
-    cnf.append([-top_lit])
+def _process_always_false(cnf: Cnf, top_lit: Lit, _: list[Lit]):
+    cnf.add_clause([-top_lit])
 
 
-def _process_not_or_lnot(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
-    cnf.append([lits[0], top_lit])
-    cnf.append([-lits[0], -top_lit])
+def _process_not_or_lnot(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
+    cnf.add_clause([lits[0], top_lit])
+    cnf.add_clause([-lits[0], -top_lit])
 
 
-def _process_rnot(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
-    cnf.append([lits[1], top_lit])
-    cnf.append([-lits[1], -top_lit])
+def _process_rnot(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
+    cnf.add_clause([lits[1], top_lit])
+    cnf.add_clause([-lits[1], -top_lit])
 
 
-def _process_iff_or_liff(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
-    cnf.append([lits[0], -top_lit])
-    cnf.append([-lits[0], top_lit])
+def _process_iff_or_liff(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
+    cnf.add_clause([lits[0], -top_lit])
+    cnf.add_clause([-lits[0], top_lit])
 
 
-def _process_riff(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
-    cnf.append([lits[1], -top_lit])
-    cnf.append([-lits[1], top_lit])
+def _process_riff(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
+    cnf.add_clause([lits[1], -top_lit])
+    cnf.add_clause([-lits[1], top_lit])
 
 
-def _process_and(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_and(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     common = [top_lit]
     for lit in lits:
         common.append(-lit)
-        cnf.append([lit, -top_lit])
-    cnf.append(common)
+        cnf.add_clause([lit, -top_lit])
+    cnf.add_clause(common)
 
 
-def _process_nand(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_nand(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     common = [-top_lit]
     for lit in lits:
         common.append(-lit)
-        cnf.append([lit, top_lit])
-    cnf.append(common)
+        cnf.add_clause([lit, top_lit])
+    cnf.add_clause(common)
 
 
-def _process_or(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_or(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     common = [-top_lit]
     for lit in lits:
         common.append(lit)
-        cnf.append([-lit, top_lit])
-    cnf.append(common)
+        cnf.add_clause([-lit, top_lit])
+    cnf.add_clause(common)
 
 
-def _process_nor(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_nor(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     common = [top_lit]
     for lit in lits:
         common.append(lit)
-        cnf.append([-lit, -top_lit])
-    cnf.append(common)
+        cnf.add_clause([-lit, -top_lit])
+    cnf.add_clause(common)
 
 
-def _process_xor(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_xor(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     a, b, c = lits[0], lits[1], top_lit
-    cnf.append([-a, -b, -c])
-    cnf.append([-a, b, c])
-    cnf.append([a, -b, c])
-    cnf.append([a, b, -c])
+    cnf.add_clause([-a, -b, -c])
+    cnf.add_clause([-a, b, c])
+    cnf.add_clause([a, -b, c])
+    cnf.add_clause([a, b, -c])
 
 
-def _process_nxor(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_nxor(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     a, b, c = lits[0], lits[1], top_lit
-    cnf.append([-a, -b, c])
-    cnf.append([-a, b, -c])
-    cnf.append([a, -b, -c])
-    cnf.append([a, b, c])
+    cnf.add_clause([-a, -b, c])
+    cnf.add_clause([-a, b, -c])
+    cnf.add_clause([a, -b, -c])
+    cnf.add_clause([a, b, c])
 
 
-def _process_gt(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_gt(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     a, b, c = lits[0], lits[1], top_lit
-    cnf.append([a, -c])
-    cnf.append([-b, -c])
-    cnf.append([-a, b, c])
+    cnf.add_clause([a, -c])
+    cnf.add_clause([-b, -c])
+    cnf.add_clause([-a, b, c])
 
 
-def _process_lt(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_lt(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     a, b, c = lits[0], lits[1], top_lit
-    cnf.append([-a, -c])
-    cnf.append([b, -c])
-    cnf.append([a, -b, c])
+    cnf.add_clause([-a, -c])
+    cnf.add_clause([b, -c])
+    cnf.add_clause([a, -b, c])
 
 
-def _process_geq(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_geq(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     a, b, c = lits[0], lits[1], top_lit
-    cnf.append([-a, c])
-    cnf.append([b, c])
-    cnf.append([a, -b, -c])
+    cnf.add_clause([-a, c])
+    cnf.add_clause([b, c])
+    cnf.add_clause([a, -b, -c])
 
 
-def _process_leq(cnf: CnfRaw, top_lit: Lit, lits: list[Lit]):
+def _process_leq(cnf: Cnf, top_lit: Lit, lits: list[Lit]):
     a, b, c = lits[0], lits[1], top_lit
-    cnf.append([a, c])
-    cnf.append([-b, c])
-    cnf.append([-a, b, -c])
+    cnf.add_clause([a, c])
+    cnf.add_clause([-b, c])
+    cnf.add_clause([-a, b, -c])
+
+
+_OPERATIONS: dict[GateType, tp.Callable[[Cnf, Lit, list[Lit]], None]] = {
+    INPUT: _process_input,
+    ALWAYS_TRUE: _process_always_true,
+    ALWAYS_FALSE: _process_always_false,
+    NOT: _process_not_or_lnot,
+    LNOT: _process_not_or_lnot,
+    RNOT: _process_rnot,
+    IFF: _process_iff_or_liff,
+    LIFF: _process_iff_or_liff,
+    RIFF: _process_riff,
+    AND: _process_and,
+    NAND: _process_nand,
+    OR: _process_or,
+    NOR: _process_nor,
+    XOR: _process_xor,
+    NXOR: _process_nxor,
+    GT: _process_gt,
+    LT: _process_lt,
+    GEQ: _process_geq,
+    LEQ: _process_leq,
+}
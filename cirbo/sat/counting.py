@@ -0,0 +1,413 @@
+"""
+Module contains exact counting of input assignments which make outputs of a circuit
+true (e.g. the number of inputs distinguishing circuits of a miter). Circuits with few
+inputs are simulated bit-parallel on all assignments by the native program of
+`mockturtle_wrapper`, which popcounts satisfying assignments with GIL released, so the
+work is shared by threads. Larger circuits are split into sub-problems on several
+inputs, each counted by a #SAT (DPLL with component caching) counter on the Tseytin
+encoding of the circuit. The counter is Python code holding the GIL, so sub-problems
+are shared by processes.
+
+"""
+
+import concurrent.futures
+import functools
+import itertools
+import logging
+import operator
+import typing as tp
+
+from cirbo.core.circuit import Circuit, INPUT, Label
+from cirbo.core.circuit.compiled import compile_native_program
+from cirbo.core.circuit.simulation import (
+    BitProgram,
+    compile_bit_program,
+    popcount,
+    simulate_block,
+)
+from cirbo.sat.cnf import Cnf, Lit, tseytin_transformation
+
+__all__ = [
+    'count_satisfying_assignments',
+    'count_models',
+]
+
+
+logger = logging.getLogger(__name__)
+
+
+# Circuits with at most this number of inputs are counted by simulation.
+_SIMULATION_LIMIT = 32
+
+# Number of inputs varying along bits of a 64-bit word of the native program.
+_WORD_INPUTS = 6
+
+# Number of inputs simulated in parallel within one big integer by simulation in
+# Python, which is used when package is built without extensions.
+_BLOCK_INPUTS = 16
+
+# Number of inputs the problem is split on when it's counted by #SAT.
+_SPLIT_INPUTS = 4
+
+_Clause = tuple[Lit, ...]
+
+# Step of the counter, which yields steps whose results it needs, and returns its own
+# result. Steps are run on an explicit stack, so depth of branching isn't bounded by
+# the recursion limit of Python.
+_Step = tp.Generator['_Step', int, int]
+
+
+def count_satisfying_assignments(
+    circuit: Circuit,
+    outputs: tp.Optional[list[int]] = None,
+    *,
+    simulation_limit: int = _SIMULATION_LIMIT,
+    split_inputs: int = _SPLIT_INPUTS,
+    workers: int = 1,
+) -> int:
+    """
+    Counts assignments of circuit inputs which make all the given outputs true. To
+    count inputs on which two circuits differ, apply this function to their miter.
+
+    If number of inputs is at most `simulation_limit`, the circuit is simulated on all
+    assignments, 64 of which are processed at once as bits of a machine word, by
+    threads running native code. Otherwise, the problem is split into
+    `2 ** split_inputs` sub-problems by fixing inputs with the largest fanout, and
+    each of them is counted by `count_models` on the Tseytin encoding of the circuit
+    in separate processes.
+
+    :param circuit: circuit to be analysed.
+    :param outputs: indices of outputs which should be true, all outputs by default.
+    :param simulation_limit: maximum number of inputs for which simulation is used.
+    :param split_inputs: number of inputs to split the #SAT problem on.
+    :param workers: number of threads (for simulation) or processes (for #SAT)
+        sharing the work.
+    :return: exact number of satisfying assignments.
+
+    """
+    if outputs is None:
+        outputs = list(range(circuit.output_size))
+    output_labels = [circuit.output_at_index(i) for i in outputs]
+    if circuit.input_size <= simulation_limit:
+        return _count_by_simulation(circuit, output_labels, workers)
+    return _count_by_splitting(circuit, outputs, output_labels, split_inputs, workers)
+
+
+def count_models(
+    clauses: tp.Iterable[tp.Iterable[Lit]],
+    number_of_variables: tp.Optional[int] = None,
+    *,
+    priority: tp.Iterable[int] = (),
+) -> int:
+    """
+    Counts models of CNF formula by DPLL with unit propagation, decomposition of the
+    formula into independent components and caching of component counts.
+
+    :param clauses: clauses of the formula.
+    :param number_of_variables: number of variables (numbered from 1) the models are
+        counted over, maximum variable of the formula by default.
+    :param priority: variables to branch on first in the given order, e.g. inputs of
+        a circuit, whose values determine values of all other variables. Ordering
+        inputs along the structure of the circuit makes caching much more effective.
+    :return: exact number of models.
+
+    """
+    formula = [tuple(sorted(set(clause))) for clause in clauses]
+    occurring = {abs(literal) for clause in formula for literal in clause}
+    if number_of_variables is None:
+        number_of_variables = max(occurring, default=0)
+    variables = set(range(1, number_of_variables + 1))
+    if not occurring <= variables:
+        raise ValueError("Formula contains variables exceeding number_of_variables.")
+    return _ModelCounter(priority).count(formula, variables)
+
+
+def _count_by_simulation(
+    circuit: Circuit,
+    output_labels: list[Label],
+    workers: int,
+) -> int:
+    native = compile_native_program(circuit, output_labels)
+    if native is not None:
+        words = 1 << (circuit.input_size - min(circuit.input_size, _WORD_INPUTS))
+        word_ranges = _split_range(words, workers)
+        if workers <= 1 or len(word_ranges) == 1:
+            return native.count_satisfying(0, words)
+        # Native program releases GIL, so threads run it in parallel.
+        with concurrent.futures.ThreadPoolExecutor(max_workers=workers) as executor:
+            return sum(
+                executor.map(
+                    lambda r: native.count_satisfying(r.start, r.stop), word_ranges
+                )
+            )
+
+    # Simulation in Python holds GIL, so the work is shared by processes.
+    program = compile_bit_program(circuit, output_labels)
+    block_inputs = min(circuit.input_size, _BLOCK_INPUTS)
+    blocks = 1 << (circuit.input_size - block_inputs)
+    task = functools.partial(_count_blocks, program, block_inputs)
+    ranges = _split_range(blocks, workers)
+    if workers <= 1 or len(ranges) == 1:
+        return sum(map(task, ranges))
+    with concurrent.futures.ProcessPoolExecutor(max_workers=workers) as executor:
+        return sum(executor.map(task, ranges))
+
+
+def _split_range(size: int, parts: int) -> list[range]:
+    parts = max(1, min(parts, size))
+    bounds = [size * i // parts for i in range(parts + 1)]
+    return [range(bounds[i], bounds[i + 1]) for i in range(parts)]
+
+
+def _count_blocks(program: BitProgram, block_inputs: int, blocks: range) -> int:
+    """:return: number of satisfying assignments among the given blocks."""
+    mask = (1 << (1 << block_inputs)) - 1
+    count = 0
+    for block in blocks:
+        outputs = simulate_block(program, block_inputs, block)
+        count += popcount(functools.reduce(operator.and_, outputs, mask))
+    return count
+
+
+def _count_by_splitting(
+    circuit: Circuit,
+    outputs: list[int],
+    output_labels: list[Label],
+    split_inputs: int,
+    workers: int,
+) -> int:
+    # Inputs are numbered from 1 in the Tseytin encoding.
+    cnf = tseytin_transformation(circuit, outputs)
+    input_variables = {label: i + 1 for i, label in enumerate(circuit.inputs)}
+    number_of_variables = max(cnf.number_of_variables, circuit.input_size)
+
+    order = _inputs_in_dfs_order(circuit, output_labels)
+    fanout = dict.fromkeys(circuit.inputs, 0)
+    for _gate in circuit.top_sort(inverse=True):
+        for operand in _gate.operands:
+            if operand in fanout:
+                fanout[operand] += 1
+    for label in output_labels:
+        if label in fanout:
+            fanout[label] += 1
+    chosen = sorted(order, key=lambda label: -fanout[label])[:split_inputs]
+    split = [input_variables[label] for label in chosen]
+    logger.debug(f"Counting {2 ** len(split)} sub-problems by #SAT")
+
+    cubes = [
+        [variable if value else -variable for variable, value in zip(split, values)]
+        for values in itertools.product((False, True), repeat=len(split))
+    ]
+    task = functools.partial(
+        _count_cubes,
+        cnf,
+        number_of_variables,
+        [input_variables[label] for label in order],
+        cubes,
+    )
+    ranges = _split_range(len(cubes), workers)
+    if workers <= 1 or len(ranges) == 1:
+        return sum(map(task, ranges))
+    with concurrent.futures.ProcessPoolExecutor(max_workers=workers) as executor:
+        return sum(executor.map(task, ranges))
+
+
+def _inputs_in_dfs_order(circuit: Circuit, output_labels: list[Label]) -> list[Label]:
+    """
+    :return: inputs of the cone of the given outputs in order they are reached by
+        depth-first search from the outputs, so inputs of close gates are close.
+
+    """
+    order: list[Label] = []
+    visited: set[Label] = set()
+    stack = list(reversed(output_labels))
+    while stack:
+        label = stack.pop()
+        if label in visited:
+            continue
+        visited.add(label)
+        _gate = circuit.get_gate(label)
+        if _gate.gate_type == INPUT:
+            order.append(label)
+        stack.extend(reversed(_gate.operands))
+    return order
+
+
+def _count_cubes(
+    cnf: Cnf,
+    number_of_variables: int,
+    priority: list[int],
+    cubes: list[list[Lit]],
+    indices: range,
+) -> int:
+    # Counter and its cache are shared by sub-problems, which have much in common.
+    counter = _ModelCounter(priority)
+    formula = [tuple(sorted(set(clause))) for clause in cnf]
+    variables = set(range(1, number_of_variables + 1))
+    return sum(counter.count(formula, variables, cubes[i]) for i in indices)
+
+
+class _ModelCounter:
+    def __init__(self, priority: tp.Iterable[int]):
+        self._rank = {variable: i for i, variable in enumerate(priority)}
+        self._cache: dict[frozenset[_Clause], int] = {}
+
+    def count(
+        self,
+        clauses: list[_Clause],
+        variables: set[int],
+        assumptions: tp.Sequence[Lit] = (),
+    ) -> int:
+        """
+        :return: number of assignments of `variables` satisfying `clauses` and given
+            assumptions, all variables of which are among `variables`.
+
+        """
+        return _run(self._count(clauses, variables, assumptions))
+
+    def _count(
+        self,
+        clauses: list[_Clause],
+        variables: set[int],
+        assumptions: tp.Sequence[Lit],
+    ) -> _Step:
+        propagated = _propagate(clauses, assumptions)
+        if propagated is None:
+            return 0
+        clauses, assigned = propagated
+        components, occurring = _components(clauses)
+        result = 1 << (len(variables) - assigned - occurring)
+        for component in components:
+            result *= yield self._count_component(component)
+            if result == 0:
+                break
+        return result
+
+    def _count_component(self, clauses: list[_Clause]) -> _Step:
+        key = frozenset(clauses)
+        if key in self._cache:
+            return self._cache[key]
+
+        occurrences: dict[int, int] = {}
+        for clause in clauses:
+            for literal in clause:
+                occurrences[abs(literal)] = occurrences.get(abs(literal), 0) + 1
+        ranked = [v for v in occurrences if v in self._rank]
+        if ranked:
+            variable = min(ranked, key=self._rank.__getitem__)
+        else:
+            variable = max(occurrences, key=lambda v: (occurrences[v], -v))
+        variables = set(occurrences)
+        result = yield self._count(clauses, variables, [variable])
+        result += yield self._count(clauses, variables, [-variable])
+        self._cache[key] = result
+        return result
+
+
+def _run(step: _Step) -> int:
+    """
+    Runs step of the counter, running steps it yields on an explicit stack.
+
+    :return: result of the step.
+
+    """
+    stack = [step]
+    value: tp.Optional[int] = None
+    while stack:
+        try:
+            # Steps receive None when started, and results of their sub-steps later.
+            call = stack[-1].send(value)  # type: ignore
+        except StopIteration as stop:
+            stack.pop()
+            value = stop.value
+        else:
+            stack.append(call)
+            value = None
+    assert value is not None
+    return value
+
+
+def _propagate(
+    clauses: list[_Clause],
+    assumptions: tp.Sequence[Lit],
+) -> tp.Optional[tuple[list[_Clause], int]]:
+    """
+    :return: clauses simplified by assumptions and unit propagation, and number of
+        assigned variables, or None if a conflict is found.
+
+    """
+    if any(not clause for clause in clauses):
+        return None
+
+    by_variable: dict[int, list[int]] = {}
+    for i, clause in enumerate(clauses):
+        for literal in clause:
+            by_variable.setdefault(abs(literal), []).append(i)
+
+    value: dict[int, bool] = {}
+    queue = list(assumptions)
+    queue.extend(clause[0] for clause in clauses if len(clause) == 1)
+    while queue:
+        literal = queue.pop()
+        if abs(literal) in value:
+            if value[abs(literal)] != (literal > 0):
+                return None
+            continue
+        value[abs(literal)] = literal > 0
+        for i in by_variable.get(abs(literal), ()):
+            unassigned = []
+            for other in clauses[i]:
+                if abs(other) not in value:
+                    unassigned.append(other)
+                elif value[abs(other)] == (other > 0):
+                    break
+            else:
+                if not unassigned:
+                    return None
+                if len(unassigned) == 1:
+                    queue.append(unassigned[0])
+    if not value:
+        return clauses, 0
+
+    result = []
+    for clause in clauses:
+        simplified = []
+        for literal in clause:
+            if abs(literal) not in value:
+                simplified.append(literal)
+            elif value[abs(literal)] == (literal > 0):
+                break
+        else:
+            result.append(tuple(simplified))
+    return result, len(value)
+
+
+def _components(clauses: list[_Clause]) -> tuple[list[list[_Clause]], int]:
+    """
+    :return: groups of clauses having no common variables with other groups, and
+        number of variables occurring in clauses.
+
+    """
+    by_variable: dict[int, list[int]] = {}
+    for i, clause in enumerate(clauses):
+        for literal in clause:
+            by_variable.setdefault(abs(literal), []).append(i)
+
+    visited = [False] * len(clauses)
+    components = []
+    for start in range(len(clauses)):
+        if visited[start]:
+            continue
+        visited[start] = True
+        component = []
+        stack = [start]
+        while stack:
+            i = stack.pop()
+            component.append(clauses[i])
+            for literal in clauses[i]:
+                for j in by_variable[abs(literal)]:
+                    if not visited[j]:
+                        visited[j] = True
+                        stack.append(j)
+        components.append(component)
+    return components, len(by_variable)
@@ -0,0 +1,179 @@
+"""
+Module contains CNF preprocessing (unit propagation, subsumption, equivalent literal
+substitution, bounded variable elimination, etc.) performed by the native CaDiCaL-based
+preprocessor of PySAT, and reconstruction of models of the original formula from
+models of the preprocessed one.
+
+"""
+
+import dataclasses
+import logging
+import time
+import typing as tp
+
+from cirbo.sat.cnf import Clause, Lit
+
+
+__all__ = [
+    'PreprocessingStats',
+    'PreprocessedFormula',
+    'preprocess',
+]
+
+
+logger = logging.getLogger(__name__)
+
+
+@dataclasses.dataclass(frozen=True)
+class PreprocessingStats:
+    """
+    Statistics of CNF preprocessing.
+
+    :param variables_before: number of variables of the original formula.
+    :param clauses_before: number of clauses of the original formula.
+    :param variables_after: number of variables occurring in the preprocessed formula.
+    :param clauses_after: number of clauses of the preprocessed formula.
+    :param time: time in seconds spent on preprocessing.
+
+    """
+
+    variables_before: int
+    clauses_before: int
+    variables_after: int
+    clauses_after: int
+    time: float
+
+    @property
+    def clauses_reduction(self) -> float:
+        """
+        :return: fraction of clauses removed by preprocessing.
+
+        """
+        if self.clauses_before == 0:
+            return 0.0
+        return 1 - self.clauses_after / self.clauses_before
+
+    @property
+    def variables_reduction(self) -> float:
+        """
+        :return: fraction of variables removed by preprocessing.
+
+        """
+        if self.variables_before == 0:
+            return 0.0
+        return 1 - self.variables_after / self.variables_before
+
+
+class PreprocessedFormula:
+    """
+    Result of CNF preprocessing. Keeps the native preprocessor alive until `delete` is
+    called (or the object is used as a context manager), since it's needed to
+    reconstruct models of the original formula.
+
+    """
+
+    def __init__(
+        self,
+        processor: tp.Any,
+        clauses: list[Clause],
+        stats: PreprocessingStats,
+    ):
+        # Native `pysat.process.Processor`.
+        self._processor: tp.Optional[tp.Any] = processor
+        self._clauses = clauses
+        self._stats = stats
+
+    @property
+    def clauses(self) -> list[Clause]:
+        """
+        :return: clauses of the preprocessed formula.
+
+        """
+        return self._clauses
+
+    @property
+    def stats(self) -> PreprocessingStats:
+        return self._stats
+
+    @property
+    def is_unsatisfiable(self) -> bool:
+        """
+        :return: True if preprocessing already proved the formula unsatisfiable.
+
+        """
+        return any(len(clause) == 0 for clause in self._clauses)
+
+    def restore(self, model: tp.Sequence[Lit]) -> list[Lit]:
+        """
+        :param model: model of the preprocessed formula.
+        :return: model of the original formula.
+
+        """
+        if self._processor is None:
+            raise ValueError("Preprocessor is already deleted.")
+        return list(self._processor.restore(list(model)))
+
+    def delete(self) -> None:
+        """Releases the native preprocessor."""
+        if self._processor is not None:
+            self._processor.delete()
+            self._processor = None
+
+    def __enter__(self) -> 'PreprocessedFormula':
+        return self
+
+    def __exit__(self, *_: tp.Any) -> None:
+        self.delete()
+
+
+def preprocess(
+    clauses: tp.Iterable[tp.Iterable[Lit]],
+    *,
+    rounds: int = 1,
+) -> PreprocessedFormula:
+    """
+    Preprocesses CNF formula. Resulting formula is equisatisfiable to the original one,
+    and each its model can be extended to a model of the original formula using
+    `PreprocessedFormula.restore`. Since variables may be eliminated, literals which
+    would be assumed in solver calls should rather be added as unit clauses.
+
+    :param clauses: clauses of the formula.
+    :param rounds: number of preprocessing rounds.
+    :return: preprocessed formula.
+
+    """
+    # Imported here, since the preprocessor is available only in recent PySAT versions.
+    from pysat.process import Processor
+
+    start = time.monotonic()
+    processor = Processor()
+    # Clauses are fed one by one, so no copy of the original formula is made.
+    variables: set[int] = set()
+    clauses_before = 0
+    for clause in clauses:
+        clause = list(clause)
+        variables.update(abs(literal) for literal in clause)
+        clauses_before += 1
+        processor.add_clause(clause)
+    # Unsatisfiability proved by preprocessing is reported by an empty clause of
+    # the resulting formula.
+    processed = processor.process(rounds=rounds)
+    processed_clauses = [list(clause) for clause in processed.clauses]
+
+    stats = PreprocessingStats(
+        variables_before=len(variables),
+        clauses_before=clauses_before,
+        variables_after=_count_variables(processed_clauses),
+        clauses_after=len(processed_clauses),
+        time=time.monotonic() - start,
+    )
+    logger.debug(
+        f"Preprocessing: {stats.clauses_before} -> {stats.clauses_after} clauses, "
+        f"{stats.variables_before} -> {stats.variables_after} variables, "
+        f"{stats.time:.2f}s"
+    )
+    return PreprocessedFormula(processor, processed_clauses, stats)
+
+
+def _count_variables(clauses: list[Clause]) -> int:
+    return len({abs(literal) for clause in clauses for literal in clause})
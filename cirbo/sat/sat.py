@@ -2,11 +2,11 @@ import dataclasses
 import enum
 import typing as tp
 
-import pysat.formula
 import pysat.solvers
 
 from cirbo.core.circuit import Circuit
 from cirbo.sat.cnf import Cnf
+from cirbo.sat.preprocessing import preprocess as preprocess_cnf, PreprocessingStats
 
 
 __all__ = [
@@ -46,30 +46,48 @@ class PySatResult:
 
     answer is bool, model shows var values, like [1, -2, 3, -4, ...].
     Model is None if answer is False.
+    preprocessing contains statistics of CNF preprocessing if it was performed.
 
     """
 
     answer: bool
     model: tp.Optional[list[int]]
+    preprocessing: tp.Optional[PreprocessingStats] = None
 
 
 def is_satisfiable(
     cnf: Cnf,
     *,
     solver_name: tp.Union[PySATSolverNames, str] = PySATSolverNames.CADICAL195,
+    preprocess: bool = False,
 ) -> PySatResult:
     """
     Checks if provided ``Cnf`` is satisfiable using specified solver.
 
     :param cnf: Cnf formula to be checked for satisfiability.
     :param solver_name: solver type/name.
+    :param preprocess: if True, formula is simplified by CNF preprocessor before
+        solving, and the model is reconstructed for the original formula.
     :return: result returned from PySat.
 
     """
     solver_name = PySATSolverNames(solver_name)
-    _pysat_cnf = pysat.formula.CNF(from_clauses=cnf.get_raw())
+    if preprocess:
+        with preprocess_cnf(cnf) as formula:
+            if formula.is_unsatisfiable:
+                return PySatResult(False, None, formula.stats)
+            with pysat.solvers.Solver(
+                name=solver_name.value, bootstrap_with=formula.clauses
+            ) as _solver:
+                if not _solver.solve():
+                    return PySatResult(False, None, formula.stats)
+                model = formula.restore(_solver.get_model())
+                return PySatResult(True, model, formula.stats)
+
     with pysat.solvers.Solver(name=solver_name.value) as _solver:
-        _solver.append_formula(_pysat_cnf)
+        # Clauses are passed to the solver one by one straight from the flat buffer,
+        # without building an intermediate copy of the formula.
+        _solver.append_formula(cnf)
         return PySatResult(_solver.solve(), _solver.get_model())
 
 
@@ -77,6 +95,8 @@ def is_circuit_satisfiable(
     circuit: Circuit,
     *,
     solver_name: tp.Union[PySATSolverNames, str] = PySATSolverNames.CADICAL195,
+    polarity_aware: bool = False,
+    preprocess: bool = False,
 ) -> PySatResult:
     """
     Checks if circuit is satisfiable using specified solver. Uses Tseytin transformation
@@ -84,10 +104,16 @@ def is_circuit_satisfiable(
 
     :param circuit: Circuit representing a Circuit SAT instance.
     :param solver_name: solver type/name.
+    :param polarity_aware: if True, circuit is converted to CNF by polarity-aware
+        simplifying transformation, which gives smaller formula. In this case only
+        values of input variables (first variables of the model) are meaningful.
+    :param preprocess: if True, formula is simplified by CNF preprocessor before
+        solving.
     :return: result returned from PySat.
 
     """
     return is_satisfiable(
-        cnf=Cnf.from_circuit(circuit),
+        cnf=Cnf.from_circuit(circuit, polarity_aware=polarity_aware),
         solver_name=solver_name,
+        preprocess=preprocess,
     )
@@ -4,10 +4,16 @@ collection located in `generation` and especially `generation.arithmetics`
 subpackages."""
 
 from . import generation
-from .circuit_search import CircuitFinderSat
+from .circuit_search import (
+    CircuitFinderSat,
+    find_min_size_circuit,
+    find_size_depth_pareto_front,
+)
 
 __all__ = [
     'generation',
     # circuit_search.py
     'CircuitFinderSat',
+    'find_min_size_circuit',
+    'find_size_depth_pareto_front',
 ]
@@ -2,13 +2,10 @@ import datetime
 import enum
 import itertools
 import logging
-import multiprocessing as mp
-import os
+import threading
+import time
 import typing as tp
 
-from concurrent.futures import TimeoutError
-
-import pebble
 from pysat.formula import CNF, IDPool
 from pysat.solvers import Solver
 
@@ -38,6 +35,8 @@ from cirbo.core.circuit import (
 )
 from cirbo.core.logic import DontCare
 from cirbo.sat import PySATSolverNames
+from cirbo.sat.cnf import AtMostOneEncoding, exactly_one
+from cirbo.sat.preprocessing import preprocess as preprocess_cnf, PreprocessingStats
 from cirbo.synthesis.exception import (
     FixGateError,
     FixGateOrderError,
@@ -49,11 +48,19 @@ from cirbo.synthesis.exception import (
 
 logger = logging.getLogger(__name__)
 
+# Number of truth table rows initially encoded in CEGIS mode.
+_CEGIS_INITIAL_ROWS = 4
+
+# Maximum number of counterexample rows added to the formula after each candidate.
+_CEGIS_ROWS_PER_STEP = 4
+
 __all__ = [
     'Basis',
     'resolve_basis',
     'Operation',
     'CircuitFinderSat',
+    'find_min_size_circuit',
+    'find_size_depth_pareto_front',
 ]
 
 
@@ -162,18 +169,71 @@ def _get_GateType_by_tt(gate_tt: tp.List[bool]) -> GateType:
     return _tt_to_gate_type[tuple(gate_tt)]
 
 
-def _mp_ctx():
-    # 'spawn' will be used on windows instead of a 'fork'.
-    return mp.get_context("spawn" if os.name == "nt" else "fork")
+def _iterate_bits(value: int) -> tp.Iterator[int]:
+    """
+    :return: iterator over positions of set bits of the value in increasing order.
 
+    """
+    while value:
+        lowest = value & -value
+        yield lowest.bit_length() - 1
+        value ^= lowest
+
+
+def _solve_limited(
+    solver: Solver,
+    *,
+    assumptions: tp.Sequence[int] = (),
+    deadline: tp.Optional[float] = None,
+    conflict_budget: tp.Optional[int] = None,
+    propagation_budget: tp.Optional[int] = None,
+) -> bool:
+    """
+    Runs the solver in the current thread until it finishes, the deadline passes (the
+    solver is interrupted by a timer) or one of the budgets is exhausted. The solver
+    releases the GIL while solving, so several solvers may run in parallel threads.
+
+    :param solver: SAT-solver with the formula loaded.
+    :param assumptions: literals assumed to be true during this call only.
+    :param deadline: value of `time.monotonic()` after which solving is interrupted.
+    :param conflict_budget: maximum number of conflicts.
+    :param propagation_budget: maximum number of propagations.
+    :return: whether the formula is satisfiable.
+    :raises SolverTimeOutError: If the solver is interrupted or runs out of budget.
+    :raises NotImplementedError: If limits are given, but the solver does not support
+        them (e.g. Lingeling or CaDiCaL before 1.9.5).
 
-def _solve_cnf(solver_name: str, clauses: list[list[int]]) -> tp.Optional[tp.List[int]]:
-    s = Solver(name=solver_name, bootstrap_with=clauses)
+    """
+    try:
+        # Budgets persist in the solver between calls, so absent budgets are reset.
+        solver.conf_budget(-1 if conflict_budget is None else conflict_budget)
+        solver.prop_budget(-1 if propagation_budget is None else propagation_budget)
+    except NotImplementedError:
+        if any(
+            limit is not None
+            for limit in (deadline, conflict_budget, propagation_budget)
+        ):
+            raise
+        # Solver supports neither budgets nor interrupts, so it is run without them.
+        return solver.solve(assumptions=list(assumptions))
+
+    timer = None
+    if deadline is not None:
+        remaining = deadline - time.monotonic()
+        if remaining <= 0:
+            raise SolverTimeOutError()
+        timer = threading.Timer(remaining, solver.interrupt)
+        timer.start()
     try:
-        sat = s.solve()
-        return s.get_model() if sat else None
+        sat = solver.solve_limited(assumptions=list(assumptions), expect_interrupt=True)
     finally:
-        s.delete()
+        if timer is not None:
+            timer.cancel()
+        solver.clear_interrupt()
+
+    if sat is None:
+        raise SolverTimeOutError()
+    return sat
 
 
 class CircuitFinderSat:
@@ -192,10 +252,19 @@ class CircuitFinderSat:
         *,
         basis: tp.Union[Basis, tp.List[Operation], str] = Basis.XAIG,
         need_normalized: bool = False,
+        at_most_one_encoding: tp.Union[
+            AtMostOneEncoding, str
+        ] = AtMostOneEncoding.PAIRWISE,
+        max_depth: tp.Optional[int] = None,
     ):
         """
         Initializes the CircuitFinder instance.
 
+        The finder keeps an incremental SAT-solver between `find_circuit` calls, so
+        the formula is encoded and loaded only once, and clauses learned by the solver
+        are reused. Call `close` to release the solver when the finder is no longer
+        needed.
+
         :param boolean_function_model:
         The function for which the circuit is needed.
         The outputs of the function must not contain two outputs,
@@ -209,6 +278,14 @@ class CircuitFinderSat:
         :param need_normalized: search for a normalization circuit, i.e.
         the circuit in which all gates satisfy the following property:
         g(0, 0) = 0.
+        :param at_most_one_encoding: encoding of the constraints that each gate has
+        exactly one pair of predecessors and each output is computed by exactly one
+        gate. Pairwise encoding needs O(k^2) clauses for k choices, while the other
+        encodings need O(k) clauses and some auxiliary variables. Pairwise encoding is
+        used by default; the other ones make formula smaller mostly in CEGIS mode, where
+        few rows of the truth table are encoded.
+        :param max_depth: if given, the maximum depth of the circuit, i.e. the maximum
+        number of gates on a path from an input to an output.
 
         """
         _basis: list[Operation]
@@ -233,10 +310,22 @@ class CircuitFinderSat:
         self._gates = list(range(boolean_function_model.input_size + number_of_gates))
         self._outputs = list(range(boolean_function_model.output_size))
         self.need_normalized = need_normalized
+        self._at_most_one_encoding = AtMostOneEncoding(at_most_one_encoding)
+        self._max_depth = max_depth
         self._vpool = IDPool()
         self._cnf = CNF()
         self._need_check_db = True
         self._need_init_cnf = True
+        self._need_init_structure = True
+        self._encoded_rows: set[int] = set()
+        # Literals of temporary constraints, passed to the solver as assumptions.
+        self._assumptions: list[int] = []
+        # Incremental solver kept between `find_circuit` calls and the number of
+        # clauses of the formula already loaded into it.
+        self._solver: tp.Optional[Solver] = None
+        self._solver_name: tp.Optional[str] = None
+        self._solver_clauses = 0
+        self._preprocessing_stats: tp.Optional[PreprocessingStats] = None
 
     def get_cnf(self) -> tp.List[tp.List[int]]:
         """
@@ -258,26 +347,52 @@ class CircuitFinderSat:
         *,
         time_limit: tp.Optional[int] = None,
         circuit_db: tp.Optional[CircuitsDatabase] = None,
+        cegis: bool = False,
+        conflict_budget: tp.Optional[int] = None,
+        propagation_budget: tp.Optional[int] = None,
+        preprocess: bool = False,
     ) -> Circuit:
         """
         Solves the Conjunctive Normal Form (CNF) using a specified SAT-solver and
         returns the circuit if it exists.
 
+        Solver runs in the current thread: time limit is enforced by interrupting it
+        from a timer, so no worker process is spawned and the formula is not copied.
+
+        In CEGIS mode (counterexample-guided inductive synthesis) the formula initially
+        encodes only a few truth table rows. Each found candidate circuit is simulated
+        on the whole truth table and rows on which it is wrong are added to the formula
+        until the candidate is correct. This makes functions with 8-10 inputs tractable,
+        since usually only a small fraction of rows needs to be encoded.
+
         :param solver_name: The name of the SAT-solver to use. Default is
             PySATSolverNames.CADICAL195 ("cadical195").
         :param time_limit : Maximum time in seconds allowed for solving (default is
             None, meaning no time limit).
         :param circuit_db: The database containing circuits. If provided, the function
             may utilize this database to find the circuit.
+        :param cegis: If True, rows of the truth table are encoded on demand (see
+            above). Has no effect if the whole formula was already built (e.g. by
+            `get_cnf`).
+        :param conflict_budget: Maximum number of conflicts allowed for a single
+            SAT-solver call (default is None, meaning no limit).
+        :param propagation_budget: Maximum number of propagations allowed for a single
+            SAT-solver call (default is None, meaning no limit).
+        :param preprocess: If True, the formula is simplified by CNF preprocessor and
+            solved by a separate solver instead of the incremental one; reduction
+            statistics are available in `preprocessing_stats`. Ignored in CEGIS mode.
         :return: Circuit: If a solution is found within the specified time limit (if
             provided), returns the found circuit. If no solution is found or the solver
             times out, the corresponding error is raised.
         :raises NoSolutionError: If no solution is found for the CNF.
-        :raises SolverTimeOutError: If the solver exceeds the specified time limit.
+        :raises SolverTimeOutError: If the solver exceeds the specified time limit or
+            budgets.
+        :raises NotImplementedError: If time limit or budgets are given, but the solver
+            does not support them (e.g. Lingeling or CaDiCaL before 1.9.5).
 
         """
 
-        if circuit_db is not None and self._need_check_db:
+        if circuit_db is not None and self._need_check_db and not self._assumptions:
             db_ret: tp.Optional[Circuit] = circuit_db.get_by_raw_truth_table_model(
                 self._output_truth_tables
             )
@@ -287,7 +402,10 @@ class CircuitFinderSat:
                 else:
                     raise NoSolutionError()
 
-        if self._need_init_cnf:
+        cegis = cegis and self._need_init_cnf
+        if cegis:
+            self._init_structure_cnf_formula()
+        elif self._need_init_cnf:
             self._init_default_cnf_formula()
             self._need_init_cnf = False
 
@@ -296,25 +414,42 @@ class CircuitFinderSat:
             f"Solving a CNF formula, "
             f"solver: {solver_name.value}, "
             f"time_limit: {time_limit}, "
+            f"cegis: {cegis}, "
             f"current time: {datetime.datetime.now()}"
         )
         if [] in self._cnf.clauses:
             raise NoSolutionError()
 
         logger.debug(f"Running {solver_name.value}")
-        if time_limit:
-            with pebble.ProcessPool(max_workers=1, context=_mp_ctx()) as pool:
-                future = pool.schedule(
-                    _solve_cnf,
-                    args=[solver_name.value, self._cnf.clauses],
-                    timeout=time_limit,
-                )
-                try:
-                    model = future.result()
-                except TimeoutError as te:
-                    raise SolverTimeOutError() from te
+        deadline = time.monotonic() + time_limit if time_limit else None
+        if preprocess and not cegis:
+            model = self._find_model_preprocessed(
+                solver_name.value,
+                deadline=deadline,
+                conflict_budget=conflict_budget,
+                propagation_budget=propagation_budget,
+            )
+            if model is None:
+                raise NoSolutionError()
+            return self._get_circuit_by_model(model)
+
+        solver = self._get_solver(solver_name.value)
+        if cegis:
+            model = self._find_model_cegis(
+                solver,
+                deadline=deadline,
+                conflict_budget=conflict_budget,
+                propagation_budget=propagation_budget,
+            )
         else:
-            model = _solve_cnf(solver_name.value, self._cnf.clauses)
+            sat = _solve_limited(
+                solver,
+                assumptions=self._assumptions,
+                deadline=deadline,
+                conflict_budget=conflict_budget,
+                propagation_budget=propagation_budget,
+            )
+            model = solver.get_model() if sat else None
 
         if model is None:
             raise NoSolutionError()
@@ -328,6 +463,7 @@ class CircuitFinderSat:
         first_predecessor: tp.Optional[int] = None,
         second_predecessor: tp.Optional[int] = None,
         gate_type: tp.Optional[GateType] = None,
+        temporary: bool = False,
     ):
         """
         Fix a specific gate in the circuit.
@@ -337,11 +473,11 @@ class CircuitFinderSat:
         :param first_predecessor: The first predecessor of the gate.
         :param second_predecessor: The second predecessor of the gate.
         :param gate_type: The gate type to be fixed.
+        :param temporary: if True, the constraint is passed to the solver as
+            assumptions instead of being added to the formula, and can be retracted
+            by `clear_temporary_constraints`.
 
         """
-
-        self._need_check_db = False
-
         if gate not in self._internal_gates:
             raise GateIsAbsentError()
 
@@ -357,42 +493,40 @@ class CircuitFinderSat:
         if first_predecessor is not None and second_predecessor is not None:
             if not (gate > second_predecessor > first_predecessor):
                 raise FixGateOrderError()
-            self._cnf.append(
-                [
-                    self._predecessors_variable(
-                        gate, first_predecessor, second_predecessor
-                    )
-                ]
-            )
         elif first_predecessor is not None:
             if not (gate > first_predecessor):
                 raise FixGateOrderError()
+
+        if first_predecessor is not None and second_predecessor is not None:
+            literal = self._predecessors_variable(
+                gate, first_predecessor, second_predecessor
+            )
+            self._add_unit(literal, temporary)
+        elif first_predecessor is not None:
             for a, b in itertools.combinations(range(gate), 2):
                 if a != first_predecessor and b != first_predecessor:
-                    self._cnf.append([-self._predecessors_variable(gate, a, b)])
+                    self._add_unit(-self._predecessors_variable(gate, a, b), temporary)
 
         if gate_type:
             for a, b in itertools.product(range(2), repeat=2):
                 bit = gate_type.operator(bool(a), bool(b))
                 assert bit in [True, False]
-                self._cnf.append(
-                    [
-                        (1 if bit else -1)
-                        * self._gate_type_variable(gate, int(a), int(b))
-                    ]
+                self._add_unit(
+                    (1 if bit else -1) * self._gate_type_variable(gate, int(a), int(b)),
+                    temporary,
                 )
 
-    def forbid_wire(self, from_gate: int, to_gate: int):
+    def forbid_wire(self, from_gate: int, to_gate: int, *, temporary: bool = False):
         """
         Forbids the wire of a circuit from one gate to another.
 
         :param from_gate: The gate to be forbidden.
         :param to_gate: The gate to be forbidden.
+        :param temporary: if True, the constraint is passed to the solver as
+            assumptions instead of being added to the formula, and can be retracted
+            by `clear_temporary_constraints`.
 
         """
-
-        self._need_check_db = False
-
         if from_gate not in self._gates:
             raise GateIsAbsentError()
         if to_gate not in self._internal_gates:
@@ -405,16 +539,80 @@ class CircuitFinderSat:
                 break
             if other == from_gate:
                 continue
-            self._cnf.append(
-                [
-                    -self._predecessors_variable(
-                        to_gate, min(other, from_gate), max(other, from_gate)
-                    )
-                ]
+            self._add_unit(
+                -self._predecessors_variable(
+                    to_gate, min(other, from_gate), max(other, from_gate)
+                ),
+                temporary,
             )
 
+    def clear_temporary_constraints(self) -> None:
+        """
+        Retracts all constraints added by `fix_gate` and `forbid_wire` with
+        `temporary=True`. The formula and the solver are kept, so the next search
+        reuses both the encoding and clauses learned by the solver.
+
+        """
+        self._assumptions = []
+
+    def close(self) -> None:
+        """Releases the incremental SAT-solver kept by the finder."""
+        if self._solver is not None:
+            self._solver.delete()
+            self._solver = None
+            self._solver_name = None
+            self._solver_clauses = 0
+
+    def __del__(self):
+        if hasattr(self, '_solver'):
+            self.close()
+
+    def _add_unit(self, literal: int, temporary: bool) -> None:
+        """
+        Adds constraint that the literal is true either to the formula or, if it is
+        temporary, to the assumptions of the next searches.
+
+        """
+        if temporary:
+            self._assumptions.append(literal)
+        else:
+            self._need_check_db = False
+            self._cnf.append([literal])
+
+    def _get_solver(self, solver_name: str) -> Solver:
+        """
+        :return: incremental solver with the whole current formula loaded.
+
+        """
+        if self._solver is not None and self._solver_name != solver_name:
+            self.close()
+        if self._solver is None:
+            self._solver = Solver(name=solver_name)
+            self._solver_name = solver_name
+        self._sync_solver()
+        return self._solver
+
+    def _sync_solver(self) -> None:
+        """Loads clauses added to the formula since the last call into the solver."""
+        assert self._solver is not None
+        self._solver.append_formula(self._cnf.clauses[self._solver_clauses :])
+        self._solver_clauses = len(self._cnf.clauses)
+
     def _init_default_cnf_formula(self) -> None:
         """Creating a CNF formula for finding a fixed-size circuit."""
+        self._init_structure_cnf_formula()
+        for t in range(1 << self._boolean_function.input_size):
+            self._add_truth_table_row(t)
+
+    def _init_structure_cnf_formula(self) -> None:
+        """
+        Creating the part of CNF formula which describes the structure of a circuit and
+        doesn't depend on truth table rows.
+
+        """
+        if not self._need_init_structure:
+            return
+        self._need_init_structure = False
 
         # gate operates on two gates predecessors
         for gate in self._internal_gates:
@@ -431,64 +629,267 @@ class CircuitFinderSat:
                 [self._output_gate_variable(h, gate) for gate in self._internal_gates]
             )
 
-        # truth values for inputs
-        for input_gate in self._input_gates:
-            for t in range(1 << self._boolean_function.input_size):
-                if self._is_dont_cares_input(t):
-                    continue
-                if (t >> (self._boolean_function.input_size - 1 - input_gate)) & 1:
-                    self._cnf.append([self._gate_value_variable(input_gate, t)])
-                else:
-                    self._cnf.append([-self._gate_value_variable(input_gate, t)])
+        # each gate computes an allowed operation
+        for gate in self._internal_gates:
+            for op in self._forbidden_operations:
+                assert len(op.value) == 4 and all(int(b) in (0, 1) for b in op.value)
+                clause = [
+                    (-1 if int(op.value[i]) == 1 else 1)
+                    * self._gate_type_variable(gate, i // 2, i % 2)
+                    for i in range(4)
+                ]
+                self._cnf.append(clause)
 
-        # gate computes the right value
+        if self.need_normalized:
+            for gate in self._internal_gates:
+                self._cnf.append([-self._gate_type_variable(gate, 0, 0)])
+
+        if self._max_depth is not None:
+            self._init_depth_cnf_formula(self._max_depth)
+
+    def _init_depth_cnf_formula(self, max_depth: int) -> None:
+        """
+        Adds to the CNF formula clauses which bound depth of every gate by `max_depth`.
+        Depth is encoded in order encoding: variable `d_{gate}_{d}` is true iff depth
+        of the gate is at most `d`, inputs have depth 0 and other gates have depth at
+        least 1. Constraining all gates rather than only outputs doesn't change the
+        minimum size, since a gate not used by outputs may as well operate on inputs.
+
+        :param max_depth: maximum depth of the circuit.
+
+        """
+        if max_depth < 1:
+            self._cnf.append([])
+            return
+
+        for gate in self._internal_gates:
+            self._cnf.append([self._depth_variable(gate, max_depth)])
+            for d in range(1, max_depth):
+                self._cnf.append(
+                    [-self._depth_variable(gate, d), self._depth_variable(gate, d + 1)]
+                )
+
+        # depth of a gate is greater than depth of its predecessors
         for gate in self._internal_gates:
             for first_pred, second_pred in itertools.combinations(range(gate), 2):
-                for a, b, c in itertools.product(range(2), repeat=3):
-                    for t in range(1 << self._boolean_function.input_size):
-                        if self._is_dont_cares_input(t):
-                            continue
+                for pred in (first_pred, second_pred):
+                    if pred in self._input_gates:
+                        continue
+                    self._cnf.append(
+                        [
+                            -self._predecessors_variable(gate, first_pred, second_pred),
+                            -self._depth_variable(gate, 1),
+                        ]
+                    )
+                    for d in range(2, max_depth + 1):
                         self._cnf.append(
                             [
                                 -self._predecessors_variable(
                                     gate, first_pred, second_pred
                                 ),
-                                (-1 if a else 1) * self._gate_value_variable(gate, t),
-                                (-1 if b else 1)
-                                * self._gate_value_variable(first_pred, t),
-                                (-1 if c else 1)
-                                * self._gate_value_variable(second_pred, t),
-                                (1 if a else -1) * self._gate_type_variable(gate, b, c),
+                                -self._depth_variable(gate, d),
+                                self._depth_variable(pred, d - 1),
                             ]
                         )
 
-        for h in self._outputs:
-            for t in range(1 << self._boolean_function.input_size):
-                if self._output_truth_tables[h][t] == DontCare:
-                    continue
-                for gate in self._internal_gates:
+    def _add_truth_table_row(self, t: int) -> None:
+        """
+        Adds to the CNF formula clauses which force the circuit to compute the right
+        values of outputs on the `t`-th truth table row. Rows which were already added
+        and rows consisting of don't cares only are skipped.
+
+        :param t: index of the truth table row.
+
+        """
+        if t in self._encoded_rows or self._is_dont_cares_input(t):
+            return
+        self._encoded_rows.add(t)
+
+        # truth values for inputs
+        for input_gate in self._input_gates:
+            if (t >> (self._boolean_function.input_size - 1 - input_gate)) & 1:
+                self._cnf.append([self._gate_value_variable(input_gate, t)])
+            else:
+                self._cnf.append([-self._gate_value_variable(input_gate, t)])
+
+        # gate computes the right value
+        for gate in self._internal_gates:
+            for first_pred, second_pred in itertools.combinations(range(gate), 2):
+                for a, b, c in itertools.product(range(2), repeat=3):
                     self._cnf.append(
                         [
-                            -self._output_gate_variable(h, gate),
-                            (1 if self._output_truth_tables[h][t] else -1)
-                            * self._gate_value_variable(gate, t),
+                            -self._predecessors_variable(gate, first_pred, second_pred),
+                            (-1 if a else 1) * self._gate_value_variable(gate, t),
+                            (-1 if b else 1) * self._gate_value_variable(first_pred, t),
+                            (-1 if c else 1)
+                            * self._gate_value_variable(second_pred, t),
+                            (1 if a else -1) * self._gate_type_variable(gate, b, c),
                         ]
                     )
 
-        # each gate computes an allowed operation
+        for h in self._outputs:
+            if self._output_truth_tables[h][t] == DontCare:
+                continue
+            for gate in self._internal_gates:
+                self._cnf.append(
+                    [
+                        -self._output_gate_variable(h, gate),
+                        (1 if self._output_truth_tables[h][t] else -1)
+                        * self._gate_value_variable(gate, t),
+                    ]
+                )
+
+    @property
+    def preprocessing_stats(self) -> tp.Optional[PreprocessingStats]:
+        """
+        :return: statistics of the last CNF preprocessing, see `find_circuit`.
+
+        """
+        return self._preprocessing_stats
+
+    def _find_model_preprocessed(
+        self,
+        solver_name: str,
+        *,
+        deadline: tp.Optional[float],
+        conflict_budget: tp.Optional[int],
+        propagation_budget: tp.Optional[int],
+    ) -> tp.Optional[tp.List[int]]:
+        """
+        Preprocesses the CNF formula together with temporary constraints and solves
+        the result.
+
+        :return: model of the original formula, or None if there is no solution.
+
+        """
+        clauses = itertools.chain(
+            self._cnf.clauses, ([literal] for literal in self._assumptions)
+        )
+        with preprocess_cnf(clauses) as formula:
+            self._preprocessing_stats = formula.stats
+            if formula.is_unsatisfiable:
+                return None
+            solver = Solver(name=solver_name, bootstrap_with=formula.clauses)
+            try:
+                sat = _solve_limited(
+                    solver,
+                    deadline=deadline,
+                    conflict_budget=conflict_budget,
+                    propagation_budget=propagation_budget,
+                )
+                return formula.restore(solver.get_model()) if sat else None
+            finally:
+                solver.delete()
+
+    def _find_model_cegis(
+        self,
+        solver: Solver,
+        *,
+        deadline: tp.Optional[float],
+        conflict_budget: tp.Optional[int],
+        propagation_budget: tp.Optional[int],
+    ) -> tp.Optional[tp.List[int]]:
+        """
+        Finds a model of the CNF formula using counterexample-guided inductive
+        synthesis: the formula initially constrains the circuit only on a few truth
+        table rows, and each found candidate circuit is simulated on the whole truth
+        table, rows on which it is wrong are added to the formula until the candidate
+        is correct.
+
+        :param solver: incremental SAT-solver with the structural part of the formula
+            loaded.
+        :param deadline: value of `time.monotonic()` after which solving is
+            interrupted.
+        :param conflict_budget: maximum number of conflicts of a single solver call.
+        :param propagation_budget: maximum number of propagations of a single solver
+            call.
+        :return: model which is correct on all truth table rows, or None if there is no
+            solution.
+        :raises SolverTimeOutError: If the solver exceeds the specified limits.
+
+        """
+        input_size = self._boolean_function.input_size
+        care_rows = [
+            t for t in range(1 << input_size) if not self._is_dont_cares_input(t)
+        ]
+        step = max(1, len(care_rows) // _CEGIS_INITIAL_ROWS)
+        for t in care_rows[::step]:
+            self._add_truth_table_row(t)
+        self._sync_solver()
+
+        # Expected values and care positions of outputs as bit masks over rows.
+        expected = [0] * len(self._outputs)
+        care = [0] * len(self._outputs)
+        for h in self._outputs:
+            for t in range(1 << input_size):
+                if self._output_truth_tables[h][t] != DontCare:
+                    care[h] |= 1 << t
+                    if self._output_truth_tables[h][t]:
+                        expected[h] |= 1 << t
+
+        while True:
+            sat = _solve_limited(
+                solver,
+                assumptions=self._assumptions,
+                deadline=deadline,
+                conflict_budget=conflict_budget,
+                propagation_budget=propagation_budget,
+            )
+            if not sat:
+                return None
+            model = solver.get_model()
+            outputs = self._simulate_model(model)
+
+            wrong = 0
+            for h in self._outputs:
+                wrong |= (outputs[h] ^ expected[h]) & care[h]
+            if not wrong:
+                return model
+
+            for t in itertools.islice(_iterate_bits(wrong), _CEGIS_ROWS_PER_STEP):
+                self._add_truth_table_row(t)
+            logger.debug(
+                f"CEGIS: {len(self._encoded_rows)} of {len(care_rows)} rows encoded"
+            )
+            self._sync_solver()
+
+    def _simulate_model(self, model: tp.List[int]) -> tp.List[int]:
+        """
+        Simulates circuit described by the model on all truth table rows at once.
+
+        :param model: model of the CNF formula.
+        :return: for each output, bit mask of rows on which it is true.
+
+        """
+        positive = set(literal for literal in model if literal > 0)
+        input_size = self._boolean_function.input_size
+        mask = (1 << (1 << input_size)) - 1
+
+        values: dict[int, int] = {}
+        for input_gate in self._input_gates:
+            shift = input_size - 1 - input_gate
+            values[input_gate] = sum(
+                1 << t for t in range(1 << input_size) if (t >> shift) & 1
+            )
+
         for gate in self._internal_gates:
-            for op in self._forbidden_operations:
-                assert len(op.value) == 4 and all(int(b) in (0, 1) for b in op.value)
-                clause = [
-                    (-1 if int(op.value[i]) == 1 else 1)
-                    * self._gate_type_variable(gate, i // 2, i % 2)
-                    for i in range(4)
-                ]
-                self._cnf.append(clause)
+            for f, s in itertools.combinations(range(gate), 2):
+                if self._predecessors_variable(gate, f, s) in positive:
+                    break
+            value = 0
+            for p, q in itertools.product(range(2), repeat=2):
+                if self._gate_type_variable(gate, p, q) in positive:
+                    value |= (values[f] if p else mask ^ values[f]) & (
+                        values[s] if q else mask ^ values[s]
+                    )
+            values[gate] = value
 
-        if self.need_normalized:
+        outputs = [0] * len(self._outputs)
+        for h in self._outputs:
             for gate in self._internal_gates:
-                self._cnf.append([-self._gate_type_variable(gate, 0, 0)])
+                if self._output_gate_variable(h, gate) in positive:
+                    outputs[h] = values[gate]
+        return outputs
 
     def _add_exactly_one_of(self, literals: tp.List[int]):
         """
@@ -498,8 +899,9 @@ class CircuitFinderSat:
         :param literals: A list of literals.
 
         """
-        self._cnf.append(literals)
-        self._cnf.extend([[-a, -b] for (a, b) in itertools.combinations(literals, 2)])
+        self._cnf.extend(
+            exactly_one(literals, self._vpool.id, self._at_most_one_encoding)
+        )
 
     def _is_dont_cares_input(self, t: int):
         """
@@ -582,6 +984,19 @@ class CircuitFinderSat:
         assert gate in self._gates
         return self._vpool.id(f'f_{gate}_{p}_{q}')
 
+    def _depth_variable(self, gate: int, d: int) -> int:
+        """
+        Returns the variable representing that depth of the gate is at most `d`.
+
+        :param gate: Index of the gate.
+        :param d: Depth bound, from 1 to the maximum depth.
+        :return: Variable representing that depth of the gate is at most `d`.
+
+        """
+        assert gate in self._internal_gates
+        assert self._max_depth is not None and 1 <= d <= self._max_depth
+        return self._vpool.id(f'd_{gate}_{d}')
+
     def _get_circuit_by_model(self, model: tp.List[int]) -> Circuit:
         """
         Create the Circuit by the truth assignment of cnf.
@@ -634,3 +1049,102 @@ class CircuitFinderSat:
                 if self._output_gate_variable(h, gate) in model:
                     initial_circuit.mark_as_output('s' + str(gate))
         return initial_circuit
+
+
+def _circuit_depth(circuit: Circuit) -> int:
+    """
+    :return: maximum number of non-input gates on a path from an input to an output.
+
+    """
+    return circuit.get_structural_metrics().depth
+
+
+def find_min_size_circuit(
+    boolean_function_model: FunctionModel,
+    *,
+    max_size: int,
+    max_depth: tp.Optional[int] = None,
+    min_size: int = 1,
+    basis: tp.Union[Basis, tp.List[Operation], str] = Basis.XAIG,
+    solver_name: tp.Union[PySATSolverNames, str] = PySATSolverNames.CADICAL195,
+    time_limit: tp.Optional[int] = None,
+) -> Circuit:
+    """
+    Finds a circuit of minimum size among circuits of depth at most `max_depth` by
+    trying sizes from `min_size` up to `max_size`.
+
+    :param boolean_function_model: the function for which the circuit is needed.
+    :param max_size: maximum size of the circuit.
+    :param max_depth: maximum depth of the circuit, not bounded if None.
+    :param min_size: size from which the search starts, e.g. a known lower bound.
+    :param basis: basis of gates in the circuit.
+    :param solver_name: the name of the SAT-solver to use.
+    :param time_limit: maximum time in seconds allowed for a single solver call.
+    :return: the found circuit.
+    :raises NoSolutionError: if there is no circuit of size at most `max_size` and
+        depth at most `max_depth`.
+    :raises SolverTimeOutError: if the solver exceeds the specified time limit.
+
+    """
+    for size in range(max(min_size, 1), max_size + 1):
+        finder = CircuitFinderSat(
+            boolean_function_model, size, basis=basis, max_depth=max_depth
+        )
+        try:
+            return finder.find_circuit(solver_name, time_limit=time_limit)
+        except NoSolutionError:
+            logger.debug(f"No circuit of size {size} and depth at most {max_depth}")
+        finally:
+            finder.close()
+    raise NoSolutionError()
+
+
+def find_size_depth_pareto_front(
+    boolean_function_model: FunctionModel,
+    *,
+    max_size: int,
+    basis: tp.Union[Basis, tp.List[Operation], str] = Basis.XAIG,
+    solver_name: tp.Union[PySATSolverNames, str] = PySATSolverNames.CADICAL195,
+    time_limit: tp.Optional[int] = None,
+) -> tp.List[Circuit]:
+    """
+    Finds the Pareto front of circuits of size at most `max_size` with respect to
+    size and depth. The search starts from the minimum size circuit and then
+    repeatedly searches for the minimum size circuit of smaller depth than the
+    previous one.
+
+    :param boolean_function_model: the function for which circuits are needed.
+    :param max_size: maximum size of circuits.
+    :param basis: basis of gates in the circuits.
+    :param solver_name: the name of the SAT-solver to use.
+    :param time_limit: maximum time in seconds allowed for a single solver call.
+    :return: circuits ordered by increasing size and decreasing depth, such that
+        no circuit of size at most `max_size` is both not larger and not deeper
+        than any of them.
+    :raises NoSolutionError: if there is no circuit of size at most `max_size`.
+    :raises SolverTimeOutError: if the solver exceeds the specified time limit.
+
+    """
+    front: tp.List[Circuit] = []
+    size, depth = 1, None
+    while depth is None or depth > 1:
+        try:
+            circuit = find_min_size_circuit(
+                boolean_function_model,
+                max_size=max_size,
+                max_depth=None if depth is None else depth - 1,
+                min_size=size,
+                basis=basis,
+                solver_name=solver_name,
+                time_limit=time_limit,
+            )
+        except NoSolutionError:
+            if not front:
+                raise
+            break
+        # Shallower circuit of the same size dominates the previous one.
+        if front and circuit.gates_number([INPUT]) == size:
+            front.pop()
+        size, depth = circuit.gates_number([INPUT]), _circuit_depth(circuit)
+        front.append(circuit)
+    return front
@@ -1,21 +1,34 @@
 from cirbo.core import Circuit
 
 try:
-    from abc_wrapper import run_abc_commands_c
+    from abc_wrapper import current_rss_bytes, run_abc_commands_c
 except ImportError:
     pass
 
 
-def abc_transform(ckt: Circuit, cmd: str) -> Circuit:
+def abc_transform(ckt: Circuit, cmd: str, *, preserve_xor: bool = False) -> Circuit:
     """
     Transforms a given boolean circuit by invoking the ABC tool with a specified command.
 
     :param ckt: The input boolean circuit to be transformed.
     :param cmd: The command string to be executed by the ABC tool
+    :param preserve_xor: If True and the command produces an AIG (e.g. ends with
+        `strash` or `dc2`), XOR and NXOR gates built of AND gates are recognized and
+        kept in the result, which is suitable for XAIG basis.
     :return: The transformed boolean circuit after processing by the ABC tool
     """
 
     bch = ckt.into_bench().format_circuit()
-    bch = run_abc_commands_c(bch, cmd)
+    bch = run_abc_commands_c(bch, cmd, preserve_xor)
     ckt = Circuit.from_bench_string(bch)
     return ckt
+
+
+def abc_memory_usage() -> int:
+    """
+    Memory accounting hook for long-running processes which call ABC.
+
+    :return: resident set size of the current process in bytes, or 0 if it can't be
+        measured on the current platform.
+    """
+    return current_rss_bytes()
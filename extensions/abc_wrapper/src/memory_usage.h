@@ -0,0 +1,49 @@
+/**
+Memory accounting helpers, which allow to monitor memory consumption of long-running
+processes calling ABC.
+**/
+
+#pragma once
+
+#include <cstddef>
+
+#if defined(__linux__)
+  #include <cstdio>
+  #include <unistd.h>
+#elif defined(__APPLE__)
+  #include <mach/mach.h>
+#endif
+
+/**
+Returns resident set size of the current process in bytes, or 0 if it is not supported
+on the current platform.
+**/
+inline std::size_t currentResidentSetSize()
+{
+#if defined(__linux__)
+    FILE *pFile = fopen("/proc/self/statm", "r");
+    if (pFile == NULL)
+    {
+        return 0;
+    }
+    long nPagesTotal = 0;
+    long nPagesResident = 0;
+    int nRead = fscanf(pFile, "%ld %ld", &nPagesTotal, &nPagesResident);
+    fclose(pFile);
+    if (nRead != 2)
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(nPagesResident) * static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+#elif defined(__APPLE__)
+    mach_task_basic_info_data_t info;
+    mach_msg_type_number_t count = MACH_TASK_BASIC_INFO_COUNT;
+    if (task_info(mach_task_self(), MACH_TASK_BASIC_INFO, reinterpret_cast<task_info_t>(&info), &count) != KERN_SUCCESS)
+    {
+        return 0;
+    }
+    return static_cast<std::size_t>(info.resident_size);
+#else
+    return 0;
+#endif
+}
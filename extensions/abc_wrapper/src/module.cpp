@@ -10,6 +10,7 @@
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "memory_usage.h"
 #include "run_abc.h"
 
 #define STRINGIFY(x) #x
@@ -19,7 +20,15 @@ namespace py = pybind11;
 
 PYBIND11_MODULE(abc_wrapper, m) {
     m.doc() = "Example doc";
-    m.def("run_abc_commands_c", &runAbcCommands, "Run ABC.");
+    m.def(
+        "run_abc_commands_c",
+        &runAbcCommands,
+        "Run ABC.",
+        py::arg("circuit"),
+        py::arg("command"),
+        py::arg("preserve_xor") = false
+    );
+    m.def("current_rss_bytes", &currentResidentSetSize, "Resident set size of the process in bytes.");
 
 #ifdef VERSION_INFO
     m.attr("__version__") = MACRO_STRINGIFY(VERSION_INFO);
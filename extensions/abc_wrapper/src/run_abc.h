@@ -9,14 +9,12 @@
   Revision    [Initial version.]
 
   Note        [The structure `Extra_FileReader_t_`, the enum `Extra_CharType_t`,
-               the macros `EXTRA_BUFFER_SIZE`, `EXTRA_OFFSET_SIZE`, and
-               `EXTRA_MINIMUM`, the function `Extra_FileReaderAllocFromString`,
-               which is a modified version of `Extra_FileReaderAlloc`, and the
-               functions `Io_ReadBenchNetwork`, `Io_WriteBenchOneNode`, and
-               `Io_WriteBenchOne` used in this file were adapted from the ABC:
-               Logic synthesis and verification system, written by Alan Mishchenko
-               at UC Berkeley. Specifically, `Extra_FileReader_t_`, `Extra_CharType_t`,
-               `EXTRA_BUFFER_SIZE`, `EXTRA_OFFSET_SIZE`, and `EXTRA_MINIMUM` were
+               the function `Extra_FileReaderAllocFromString`, which is a modified
+               version of `Extra_FileReaderAlloc`, and the functions
+               `Io_ReadBenchNetwork`, `Io_WriteBenchOneNode`, and `Io_WriteBenchOne`
+               used in this file were adapted from the ABC: Logic synthesis and
+               verification system, written by Alan Mishchenko at UC Berkeley.
+               Specifically, `Extra_FileReader_t_` and `Extra_CharType_t` were
                adapted from `extraUtilReader.c`, `Io_ReadBenchNetwork` was copied
                from `ioReadBench.c`, and `Io_WriteBenchOneNode` and `Io_WriteBenchOne`
                were copied from `ioWriteBench.c`.]
@@ -28,6 +26,11 @@
 #include <time.h>
 #include <stdlib.h>
 
+#include <memory>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
 #include <abc/src/misc/util/abc_global.h>
 #include <abc/src/misc/extra/extra.h>
 #include <abc/src/misc/vec/vec.h>
@@ -35,11 +38,6 @@
 #include <abc/src/base/main/main.h>
 #include <abc/src/base/main/mainInt.h>
 
-#define EXTRA_BUFFER_SIZE        4*1048576    // 1M   - size of the data chunk stored in memory
-#define EXTRA_OFFSET_SIZE           4096    // 4K   - load new data when less than this is left
-
-#define EXTRA_MINIMUM(a,b)       (((a) < (b))? (a) : (b))
-
 /**
 The structure of this file was adapted from extraUtilReader.c
 from the ABC: Logic synthesis and verification system, written
@@ -77,16 +75,16 @@ typedef enum {
 } Extra_CharType_t;
 
 
-Extra_FileReader_t *Extra_FileReaderAllocFromString(char *pFileContent, char *pCharsComment, char *pCharsStop, char *pCharsClean)
+Extra_FileReader_t *Extra_FileReaderAllocFromString(const char *pFileContent, const char *pCharsComment, const char *pCharsStop, const char *pCharsClean)
 {
     Extra_FileReader_t *p;
-    char *pChar;
+    const char *pChar;
     int nCharsToRead;
 
     // start the file reader
     p = ABC_ALLOC(Extra_FileReader_t, 1);
     memset(p, 0, sizeof(Extra_FileReader_t));
-    p->pFileName = "filename.bench"; // No file name since content is provided directly
+    p->pFileName = (char *)"filename.bench"; // No file name since content is provided directly
     p->pFile = NULL; // No file pointer since content is provided directly
 
     // set the character map
@@ -101,21 +99,23 @@ Extra_FileReader_t *Extra_FileReaderAllocFromString(char *pFileContent, char *pC
     // get the content size, in bytes
     p->nFileSize = strlen(pFileContent);
 
-    // allocate the buffer
-    p->pBuffer = ABC_ALLOC(char, EXTRA_BUFFER_SIZE + 1);
-    p->nBufferSize = EXTRA_BUFFER_SIZE;
+    // allocate the buffer, it holds the whole content, since there is no file
+    // to load the remaining data from
+    p->nBufferSize = p->nFileSize;
+    p->pBuffer = ABC_ALLOC(char, p->nBufferSize + 1);
     p->pBufferCur = p->pBuffer;
 
     // determine how many chars to read
-    nCharsToRead = EXTRA_MINIMUM(p->nFileSize, EXTRA_BUFFER_SIZE);
+    nCharsToRead = p->nFileSize;
 
-    // load the first part into the buffer
-    strncpy(p->pBuffer, pFileContent, nCharsToRead);
+    // load the content into the buffer
+    memcpy(p->pBuffer, pFileContent, nCharsToRead);
+    p->pBuffer[nCharsToRead] = '\0';
     p->nFileRead = nCharsToRead;
 
     // set the pointers to the end and the stopping point
     p->pBufferEnd = p->pBuffer + nCharsToRead;
-    p->pBufferStop = (p->nFileRead == p->nFileSize) ? p->pBufferEnd : p->pBuffer + EXTRA_BUFFER_SIZE - EXTRA_OFFSET_SIZE;
+    p->pBufferStop = p->pBufferEnd;
 
     // start the arrays
     p->vTokens = Vec_PtrAlloc(100);
@@ -425,26 +425,229 @@ int Io_WriteBenchOne( FILE * pFile, Abc_Ntk_t * pNtk )
     return 1;
 }
 
-char* runAbcCommands(char *pFileContent, const char *sCommand)
+/**
+Checks if AND node of a strashed network is the root of a XOR (or XNOR) of two signals,
+i.e. it is AND(NOT(AND(l1, l2)), NOT(AND(NOT(l1), NOT(l2)))), where inner AND nodes are
+used only by the root, so they may be replaced by a single XOR gate.
+**/
+bool Abc_NodeIsXorRoot( Abc_Obj_t * pNode, Abc_Obj_t ** ppFanin0, Abc_Obj_t ** ppFanin1, int * pfXnor )
 {
-    Abc_Frame_t *pAbc = Abc_FrameGetGlobalFrame();
+    Abc_Obj_t * p0, * p1;
+    if ( !Abc_ObjFaninC0(pNode) || !Abc_ObjFaninC1(pNode) )
+        return false;
+    p0 = Abc_ObjFanin0(pNode);
+    p1 = Abc_ObjFanin1(pNode);
+    if ( !Abc_AigNodeIsAnd(p0) || !Abc_AigNodeIsAnd(p1) )
+        return false;
+    if ( Abc_ObjFanoutNum(p0) != 1 || Abc_ObjFanoutNum(p1) != 1 )
+        return false;
+    // fanins of strashed nodes are ordered, so the same signals are at the same positions
+    if ( Abc_ObjFanin0(p0) != Abc_ObjFanin0(p1) || Abc_ObjFanin1(p0) != Abc_ObjFanin1(p1) )
+        return false;
+    if ( Abc_ObjFaninC0(p0) == Abc_ObjFaninC0(p1) || Abc_ObjFaninC1(p0) == Abc_ObjFaninC1(p1) )
+        return false;
+    *ppFanin0 = Abc_ObjFanin0(p0);
+    *ppFanin1 = Abc_ObjFanin1(p0);
+    *pfXnor = Abc_ObjFaninC0(p0) != Abc_ObjFaninC1(p0);
+    return true;
+}
+
+/**
+Writes strashed network in bench format, recognizing XOR and XNOR gates implemented by
+three AND nodes. Unlike `Io_WriteBenchOne` it works directly with the AIG (not with the
+netlist), so complemented edges are written as NOT gates.
+**/
+int Io_WriteBenchXorAig( FILE * pFile, Abc_Ntk_t * pNtk )
+{
+    Abc_Obj_t * pNode, * pFanin0, * pFanin1;
+    Vec_Ptr_t * vNodes;
+    int i, fXnor;
+
+    assert( Abc_NtkIsStrash(pNtk) );
+
+    // choose prefix for names of internal nodes, which doesn't clash with PI/PO names
+    std::string prefix = "n";
+    bool fClash = true;
+    while ( fClash )
+    {
+        fClash = false;
+        Abc_NtkForEachCi( pNtk, pNode, i )
+            fClash |= strncmp( Abc_ObjName(pNode), prefix.c_str(), prefix.size() ) == 0;
+        Abc_NtkForEachCo( pNtk, pNode, i )
+            fClash |= strncmp( Abc_ObjName(pNode), prefix.c_str(), prefix.size() ) == 0;
+        if ( fClash )
+            prefix = "_" + prefix;
+    }
+
+    std::vector<char> fNegated( Abc_NtkObjNumMax(pNtk), 0 );
+    auto const nodeName = [&]( Abc_Obj_t * pObj ) -> std::string {
+        if ( Abc_ObjIsCi(pObj) )
+            return Abc_ObjName(pObj);
+        return prefix + std::to_string( Abc_ObjId(pObj) );
+    };
+    // returns name of a (possibly complemented) signal, writing NOT gate when needed
+    auto const signalName = [&]( Abc_Obj_t * pObj, int fCompl ) -> std::string {
+        if ( !fCompl )
+            return nodeName( pObj );
+        std::string name = prefix + std::to_string( Abc_ObjId(pObj) ) + "_not";
+        if ( !fNegated[Abc_ObjId(pObj)] )
+        {
+            fprintf( pFile, "%s = NOT(%s)\n", name.c_str(), nodeName( pObj ).c_str() );
+            fNegated[Abc_ObjId(pObj)] = 1;
+        }
+        return name;
+    };
+
+    // write the PIs/POs
+    Abc_NtkForEachPi( pNtk, pNode, i )
+        fprintf( pFile, "INPUT(%s)\n", Abc_ObjName(pNode) );
+    Abc_NtkForEachPo( pNtk, pNode, i )
+        fprintf( pFile, "OUTPUT(%s)\n", Abc_ObjName(pNode) );
+
+    // mark nodes which are used, skipping inner nodes of XORs
+    std::vector<char> fUsed( Abc_NtkObjNumMax(pNtk), 0 );
+    Abc_NtkForEachPo( pNtk, pNode, i )
+        fUsed[Abc_ObjId(Abc_ObjFanin0(pNode))] = 1;
+    vNodes = Abc_NtkDfs( pNtk, 0 );
+    Vec_PtrForEachEntryReverse( Abc_Obj_t *, vNodes, pNode, i )
+    {
+        if ( !fUsed[Abc_ObjId(pNode)] )
+            continue;
+        if ( Abc_NodeIsXorRoot( pNode, &pFanin0, &pFanin1, &fXnor ) )
+        {
+            fUsed[Abc_ObjId(pFanin0)] = 1;
+            fUsed[Abc_ObjId(pFanin1)] = 1;
+        }
+        else
+        {
+            fUsed[Abc_ObjId(Abc_ObjFanin0(pNode))] = 1;
+            fUsed[Abc_ObjId(Abc_ObjFanin1(pNode))] = 1;
+        }
+    }
+
+    // write internal nodes in topological order
+    if ( fUsed[Abc_ObjId(Abc_AigConst1(pNtk))] )
+        fprintf( pFile, "%s = vdd\n", nodeName( Abc_AigConst1(pNtk) ).c_str() );
+    Vec_PtrForEachEntry( Abc_Obj_t *, vNodes, pNode, i )
+    {
+        if ( !fUsed[Abc_ObjId(pNode)] )
+            continue;
+        std::string type = "AND", lhs, rhs;
+        if ( Abc_NodeIsXorRoot( pNode, &pFanin0, &pFanin1, &fXnor ) )
+        {
+            type = fXnor ? "NXOR" : "XOR";
+            lhs = signalName( pFanin0, 0 );
+            rhs = signalName( pFanin1, 0 );
+        }
+        else
+        {
+            lhs = signalName( Abc_ObjFanin0(pNode), Abc_ObjFaninC0(pNode) );
+            rhs = signalName( Abc_ObjFanin1(pNode), Abc_ObjFaninC1(pNode) );
+        }
+        fprintf( pFile, "%s = %s(%s, %s)\n", nodeName( pNode ).c_str(), type.c_str(), lhs.c_str(), rhs.c_str() );
+    }
+    Vec_PtrFree( vNodes );
+
+    // connect the POs to their drivers
+    Abc_NtkForEachPo( pNtk, pNode, i )
+    {
+        std::string driver = signalName( Abc_ObjFanin0(pNode), Abc_ObjFaninC0(pNode) );
+        if ( driver != Abc_ObjName(pNode) )
+            fprintf( pFile, "%s = BUFF(%s)\n", Abc_ObjName(pNode), driver.c_str() );
+    }
+    return 1;
+}
+
+/**
+Owning pointers to ABC objects, which release them on scope exit.
+**/
+struct AbcFileReaderDeleter
+{
+    void operator()(Extra_FileReader_t *p) const { Extra_FileReaderFree(p); }
+};
+
+struct AbcNtkDeleter
+{
+    void operator()(Abc_Ntk_t *pNtk) const { Abc_NtkDelete(pNtk); }
+};
+
+struct CFileDeleter
+{
+    void operator()(FILE *pFile) const { fclose(pFile); }
+};
 
-    Extra_FileReader_t *p = Extra_FileReaderAllocFromString(pFileContent, "#", "\n\r", " \t,()=");
+struct CBufferDeleter
+{
+    void operator()(char *pBuffer) const { free(pBuffer); }
+};
+
+using AbcFileReaderPtr = std::unique_ptr<Extra_FileReader_t, AbcFileReaderDeleter>;
+using AbcNtkPtr = std::unique_ptr<Abc_Ntk_t, AbcNtkDeleter>;
+using CFilePtr = std::unique_ptr<FILE, CFileDeleter>;
+using CBufferPtr = std::unique_ptr<char, CBufferDeleter>;
+
+/**
+Runs ABC commands on a circuit given in bench format and returns the resulting circuit
+in bench format. All memory allocated for the call is released before return, networks
+of the global ABC frame included, so the function can be called repeatedly in
+long-running processes.
 
-    Abc_Ntk_t *pNtk = Io_ReadBenchNetwork(p);
-    pNtk = Abc_NtkToLogic(pNtk);
+If `preserveXor` is set and the resulting network is strashed, XOR and XNOR gates
+implemented by AND nodes are recognized and written as XOR and NXOR gates.
+**/
+std::string runAbcCommands(const std::string &fileContent, const std::string &command, bool preserveXor = false)
+{
+    Abc_Frame_t *pAbc = Abc_FrameGetGlobalFrame();
 
-    Abc_FrameReplaceCurrentNetwork(pAbc, pNtk);
+    AbcNtkPtr pNtk;
+    {
+        AbcFileReaderPtr pReader(Extra_FileReaderAllocFromString(fileContent.c_str(), "#", "\n\r", " \t,()="));
+        AbcNtkPtr pNetlist(Io_ReadBenchNetwork(pReader.get()));
+        if (!pNetlist)
+        {
+            throw std::runtime_error("ABC failed to read the circuit.");
+        }
+        pNtk.reset(Abc_NtkToLogic(pNetlist.get()));
+        if (!pNtk)
+        {
+            throw std::runtime_error("ABC failed to convert the circuit to a logic network.");
+        }
+    }
 
-    Cmd_CommandExecute(pAbc, sCommand);
+    // Frame takes ownership of the network.
+    Abc_FrameReplaceCurrentNetwork(pAbc, pNtk.release());
 
-    Abc_Ntk_t *pNtkTemp = Abc_NtkToNetlistBench(pAbc->pNtkCur);
+    std::string result;
+    bool success = false;
+    if (Cmd_CommandExecute(pAbc, command.c_str()) == 0 && pAbc->pNtkCur != NULL)
+    {
+        char *pBuffer = NULL;
+        size_t size = 0;
+        CFilePtr memFile(open_memstream(&pBuffer, &size));
+        if (memFile)
+        {
+            if (preserveXor && Abc_NtkIsStrash(pAbc->pNtkCur))
+            {
+                Io_WriteBenchXorAig(memFile.get(), pAbc->pNtkCur);
+            }
+            else
+            {
+                AbcNtkPtr pNtkTemp(Abc_NtkToNetlistBench(pAbc->pNtkCur));
+                Io_WriteBenchOne(memFile.get(), pNtkTemp.get());
+            }
+            // Buffer and its size are updated by `fclose`.
+            memFile.reset();
+            CBufferPtr buffer(pBuffer);
+            result.assign(buffer.get(), size);
+            success = true;
+        }
+    }
 
-    char *buffer;
-    size_t size;
-    FILE *memFile = open_memstream(&buffer, &size);
-    Io_WriteBenchOne(memFile, pNtkTemp);
-    fclose(memFile);
+    Abc_FrameDeleteAllNetworks(pAbc);
 
-    return buffer;
+    if (!success)
+    {
+        throw std::runtime_error("ABC failed to execute command: " + command);
+    }
+    return result;
 }
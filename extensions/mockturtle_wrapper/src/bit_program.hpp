@@ -0,0 +1,428 @@
+#pragma once
+
+#include <algorithm>
+#include <bitset>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+/**
+ * Gate of a circuit lowered for evaluation: cirbo's gate type name and positions of
+ * operands in the register array.
+ */
+using program_gate_t = std::pair<std::string, std::vector<uint32_t>>;
+
+
+/**
+ * Straight-line program evaluating a circuit on 64-bit words of packed assignments.
+ *
+ * Registers hold values of inputs followed by values of gates, each gate writes its
+ * own register, so the program is run by one pass over a flat opcode array without
+ * any lookups of labels. Assignments are processed in blocks of words, which keeps
+ * all registers of the block in cache.
+ */
+class bit_program
+{
+public:
+    /**
+     * @param input_size number of inputs, which occupy first registers.
+     * @param gates gates in topological order, `i`th of them writes register `input_size + i`.
+     * @param outputs registers of outputs.
+     */
+    bit_program(uint32_t input_size, std::vector<program_gate_t> const& gates, std::vector<uint32_t> const& outputs)
+        : input_size_(input_size), outputs_(outputs)
+    {
+        offsets_.push_back(0);
+        for (auto const& [type, operands]: gates)
+        {
+            auto const [code, arity] = parse_opcode(type);
+            if (arity >= 0 && operands.size() != static_cast<std::size_t>(arity))
+            {
+                throw std::invalid_argument("gate of type " + type + " expects " + std::to_string(arity) + " operands");
+            }
+            if (arity < 0 && operands.empty())
+            {
+                throw std::invalid_argument("gate of type " + type + " expects operands");
+            }
+            auto const reg = input_size_ + opcodes_.size();
+            for (auto operand: operands)
+            {
+                if (operand >= reg)
+                {
+                    throw std::invalid_argument("operand " + std::to_string(operand) + " is not computed before register " + std::to_string(reg));
+                }
+                operands_.push_back(operand);
+            }
+            opcodes_.push_back(code);
+            offsets_.push_back(static_cast<uint32_t>(operands_.size()));
+        }
+        for (auto output: outputs_)
+        {
+            if (output >= register_count())
+            {
+                throw std::invalid_argument("output register " + std::to_string(output) + " does not exist");
+            }
+        }
+    }
+
+    uint32_t input_size() const
+    {
+        return input_size_;
+    }
+
+    std::size_t output_size() const
+    {
+        return outputs_.size();
+    }
+
+    /**
+     * @param inputs values of inputs.
+     * @return values of outputs.
+     */
+    std::vector<bool> evaluate(std::vector<bool> const& inputs) const
+    {
+        check_input_size(inputs.size());
+        std::vector<uint64_t> words(inputs.size());
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+        {
+            words[i] = inputs[i] ? 1u : 0u;
+        }
+        std::vector<uint64_t> outputs(outputs_.size());
+        run(words.data(), outputs.data(), 1);
+
+        std::vector<bool> result;
+        for (auto word: outputs)
+        {
+            result.push_back(word & 1u);
+        }
+        return result;
+    }
+
+    /**
+     * @param inputs vectors of values of inputs, each of them is little-endian bytes
+     *     of at least `size` bits, bit `k` of which is the value in `k`th assignment.
+     * @param size number of assignments.
+     * @return vectors of values of outputs in the same format, with exactly
+     *     `(size + 7) / 8` bytes and zero bits after `size`.
+     */
+    std::vector<std::string> evaluate_packed(std::vector<std::string> const& inputs, std::size_t size) const
+    {
+        check_input_size(inputs.size());
+        auto const words = (size + 63) / 64;
+        auto const bytes = (size + 7) / 8;
+
+        std::vector<uint64_t> input_words(inputs.size() * words, 0);
+        for (std::size_t i = 0; i < inputs.size(); ++i)
+        {
+            if (inputs[i].size() < bytes)
+            {
+                throw std::invalid_argument("input " + std::to_string(i) + " has less than " + std::to_string(size) + " bits");
+            }
+            for (std::size_t b = 0; b < bytes; ++b)
+            {
+                input_words[i * words + b / 8] |= uint64_t{static_cast<unsigned char>(inputs[i][b])} << (8 * (b % 8));
+            }
+        }
+
+        std::vector<uint64_t> output_words(outputs_.size() * words);
+        run(input_words.data(), output_words.data(), words);
+
+        std::vector<std::string> result(outputs_.size(), std::string(bytes, '\0'));
+        for (std::size_t i = 0; i < outputs_.size(); ++i)
+        {
+            for (std::size_t b = 0; b < bytes; ++b)
+            {
+                result[i][b] = static_cast<char>(output_words[i * words + b / 8] >> (8 * (b % 8)));
+            }
+            if (size % 8 != 0)
+            {
+                result[i][bytes - 1] &= static_cast<char>((1u << (size % 8)) - 1);
+            }
+        }
+        return result;
+    }
+
+    /**
+     * Counts assignments of inputs making all outputs true. Assignments are ordered by
+     * their big-endian binary encoding (so the first input is the most significant
+     * bit), and each word holds 64 consecutive of them.
+     *
+     * @param first index of the first word to be counted.
+     * @param last index of the word after the last one, clipped by the number of words.
+     * @return number of satisfying assignments in these words.
+     */
+    uint64_t count_satisfying(uint64_t first, uint64_t last) const
+    {
+        // Inputs varying along bits of a word, the last of which is the least significant.
+        static constexpr uint64_t lane_patterns[] = {
+            0xAAAAAAAAAAAAAAAAu,
+            0xCCCCCCCCCCCCCCCCu,
+            0xF0F0F0F0F0F0F0F0u,
+            0xFF00FF00FF00FF00u,
+            0xFFFF0000FFFF0000u,
+            0xFFFFFFFF00000000u,
+        };
+        if (input_size_ >= 64)
+        {
+            throw std::invalid_argument("cannot count assignments of " + std::to_string(input_size_) + " inputs");
+        }
+        uint32_t const lanes = std::min<uint32_t>(input_size_, 6);
+        uint64_t const lane_mask = lanes == 6 ? ~uint64_t{0} : (uint64_t{1} << (1u << lanes)) - 1;
+        last = std::min(last, uint64_t{1} << (input_size_ - lanes));
+
+        std::vector<uint64_t> registers(register_count() * block);
+        uint64_t count = 0;
+        for (uint64_t begin = first; begin < last; begin += block)
+        {
+            auto const width = static_cast<std::size_t>(std::min<uint64_t>(block, last - begin));
+            for (uint32_t i = 0; i < input_size_; ++i)
+            {
+                uint64_t* const values = registers.data() + i * block;
+                uint32_t const significance = input_size_ - 1 - i;
+                if (significance < lanes)
+                {
+                    std::fill_n(values, width, lane_patterns[significance]);
+                    continue;
+                }
+                for (std::size_t w = 0; w < width; ++w)
+                {
+                    values[w] = ((begin + w) >> (significance - lanes)) & 1u ? ~uint64_t{0} : 0;
+                }
+            }
+            execute_all(registers.data(), width);
+            for (std::size_t w = 0; w < width; ++w)
+            {
+                uint64_t satisfied = lane_mask;
+                for (auto output: outputs_)
+                {
+                    satisfied &= registers[output * block + w];
+                }
+                count += std::bitset<64>(satisfied).count();
+            }
+        }
+        return count;
+    }
+
+private:
+    // Number of words of each register processed at once.
+    static constexpr std::size_t block = 64;
+
+    enum class opcode : uint8_t
+    {
+        always_false,
+        always_true,
+        and_,
+        nand,
+        or_,
+        nor,
+        xor_,
+        nxor,
+        not_,
+        iff,
+        lnot,
+        rnot,
+        liff,
+        riff,
+        gt,
+        lt,
+        geq,
+        leq,
+    };
+
+    /**
+     * @return opcode of gate type and its arity, which is -1 for gates taking any
+     *     positive number of operands.
+     */
+    static std::pair<opcode, int> parse_opcode(std::string const& type)
+    {
+        static std::vector<std::pair<std::string, std::pair<opcode, int>>> const opcodes = {
+            {"ALWAYS_FALSE", {opcode::always_false, 0}},
+            {"ALWAYS_TRUE", {opcode::always_true, 0}},
+            {"AND", {opcode::and_, -1}},
+            {"NAND", {opcode::nand, -1}},
+            {"OR", {opcode::or_, -1}},
+            {"NOR", {opcode::nor, -1}},
+            {"XOR", {opcode::xor_, -1}},
+            {"NXOR", {opcode::nxor, -1}},
+            {"NOT", {opcode::not_, 1}},
+            {"IFF", {opcode::iff, 1}},
+            {"LNOT", {opcode::lnot, 2}},
+            {"RNOT", {opcode::rnot, 2}},
+            {"LIFF", {opcode::liff, 2}},
+            {"RIFF", {opcode::riff, 2}},
+            {"GT", {opcode::gt, 2}},
+            {"LT", {opcode::lt, 2}},
+            {"GEQ", {opcode::geq, 2}},
+            {"LEQ", {opcode::leq, 2}},
+        };
+        for (auto const& [name, result]: opcodes)
+        {
+            if (name == type)
+            {
+                return result;
+            }
+        }
+        throw std::invalid_argument("unsupported gate type: " + type);
+    }
+
+    std::size_t register_count() const
+    {
+        return input_size_ + opcodes_.size();
+    }
+
+    void check_input_size(std::size_t size) const
+    {
+        if (size != input_size_)
+        {
+            throw std::invalid_argument("expected values of " + std::to_string(input_size_) + " inputs, got " + std::to_string(size));
+        }
+    }
+
+    /**
+     * Runs the program on `words` words of each input, stored one input after another,
+     * and writes outputs the same way.
+     */
+    void run(uint64_t const* inputs, uint64_t* outputs, std::size_t words) const
+    {
+        std::vector<uint64_t> registers(register_count() * block);
+
+        for (std::size_t begin = 0; begin < words; begin += block)
+        {
+            auto const width = std::min(block, words - begin);
+            for (std::size_t i = 0; i < input_size_; ++i)
+            {
+                std::copy_n(inputs + i * words + begin, width, registers.data() + i * block);
+            }
+            execute_all(registers.data(), width);
+            for (std::size_t i = 0; i < outputs_.size(); ++i)
+            {
+                std::copy_n(registers.data() + outputs_[i] * block, width, outputs + i * words + begin);
+            }
+        }
+    }
+
+    void execute_all(uint64_t* registers, std::size_t width) const
+    {
+        for (std::size_t g = 0; g < opcodes_.size(); ++g)
+        {
+            execute(g, registers, width);
+        }
+    }
+
+    void execute(std::size_t g, uint64_t* registers, std::size_t width) const
+    {
+        uint64_t* const result = registers + (input_size_ + g) * block;
+        uint32_t const* const operands = operands_.data() + offsets_[g];
+        auto const arity = offsets_[g + 1] - offsets_[g];
+        auto const operand = [&](std::size_t k) -> uint64_t const* {
+            return registers + operands[k] * block;
+        };
+
+        auto const fold = [&](auto combine, uint64_t negation) {
+            std::copy_n(operand(0), width, result);
+            for (std::size_t k = 1; k < arity; ++k)
+            {
+                auto const* const other = operand(k);
+                for (std::size_t w = 0; w < width; ++w)
+                {
+                    result[w] = combine(result[w], other[w]);
+                }
+            }
+            if (negation != 0)
+            {
+                for (std::size_t w = 0; w < width; ++w)
+                {
+                    result[w] ^= negation;
+                }
+            }
+        };
+        auto const unary = [&](auto combine) {
+            auto const* const arg = operand(0);
+            for (std::size_t w = 0; w < width; ++w)
+            {
+                result[w] = combine(arg[w]);
+            }
+        };
+        auto const binary = [&](auto combine) {
+            auto const* const left = operand(0);
+            auto const* const right = operand(1);
+            for (std::size_t w = 0; w < width; ++w)
+            {
+                result[w] = combine(left[w], right[w]);
+            }
+        };
+        auto const and_op = [](uint64_t a, uint64_t b) { return a & b; };
+        auto const or_op = [](uint64_t a, uint64_t b) { return a | b; };
+        auto const xor_op = [](uint64_t a, uint64_t b) { return a ^ b; };
+        constexpr uint64_t ones = ~uint64_t{0};
+
+        switch (opcodes_[g])
+        {
+        case opcode::always_false:
+            std::fill_n(result, width, uint64_t{0});
+            break;
+        case opcode::always_true:
+            std::fill_n(result, width, ones);
+            break;
+        case opcode::and_:
+            fold(and_op, 0);
+            break;
+        case opcode::nand:
+            fold(and_op, ones);
+            break;
+        case opcode::or_:
+            fold(or_op, 0);
+            break;
+        case opcode::nor:
+            fold(or_op, ones);
+            break;
+        case opcode::xor_:
+            fold(xor_op, 0);
+            break;
+        case opcode::nxor:
+            fold(xor_op, ones);
+            break;
+        case opcode::not_:
+            unary([](uint64_t a) { return ~a; });
+            break;
+        case opcode::iff:
+            unary([](uint64_t a) { return a; });
+            break;
+        case opcode::lnot:
+            binary([](uint64_t a, uint64_t) { return ~a; });
+            break;
+        case opcode::liff:
+            binary([](uint64_t a, uint64_t) { return a; });
+            break;
+        case opcode::rnot:
+            binary([](uint64_t, uint64_t b) { return ~b; });
+            break;
+        case opcode::riff:
+            binary([](uint64_t, uint64_t b) { return b; });
+            break;
+        case opcode::gt:
+            binary([](uint64_t a, uint64_t b) { return a & ~b; });
+            break;
+        case opcode::lt:
+            binary([](uint64_t a, uint64_t b) { return ~a & b; });
+            break;
+        case opcode::geq:
+            binary([](uint64_t a, uint64_t b) { return a | ~b; });
+            break;
+        case opcode::leq:
+            binary([](uint64_t a, uint64_t b) { return ~a | b; });
+            break;
+        }
+    }
+
+    uint32_t input_size_;
+    std::vector<uint32_t> outputs_;
+    std::vector<opcode> opcodes_;
+    // Operands of gate `g` are `operands_[offsets_[g]:offsets_[g + 1]]`.
+    std::vector<uint32_t> offsets_;
+    std::vector<uint32_t> operands_;
+};
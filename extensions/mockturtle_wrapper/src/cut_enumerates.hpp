@@ -1,6 +1,7 @@
 #pragma once
 
 #include <map>
+#include <stdexcept>
 #include <string>
 #include <filesystem>
 #include <iostream>
@@ -83,59 +84,112 @@ public:
     }
     else
     {
-      /* old-style gate definition */
+      /* old-style gate definition, extended with cirbo's gate types */
       std::vector<signal<Ntk>> input_signals;
       for ( const auto& i : inputs )
-        input_signals.push_back( signals[i] );
-
-      kitty::dynamic_truth_table tt( static_cast<int>( inputs.size() ) );
-
-      std::vector<kitty::dynamic_truth_table> vs( inputs.size(), tt );
-      for ( auto i = 0u; i < inputs.size(); ++i )
-        kitty::create_nth_var( vs[i], i );
-
-      if ( type == "NOT" )
-      {
-        assert( inputs.size() == 1u );
-        tt = ~vs.at( 0u );
-      }
-      else if ( type == "BUFF" )
       {
-        assert( inputs.size() == 1u );
-        tt = vs.at( 0u );
+        /* constant gates are written by cirbo as `ALWAYS_TRUE()` */
+        if ( !i.empty() )
+          input_signals.push_back( signals[i] );
       }
-      else if ( type == "AND" )
+
+      if ( type == "ALWAYS_TRUE" || type == "ALWAYS_FALSE" )
       {
-        tt = vs.at( 0u );
-        for ( auto i = 1u; i < inputs.size(); ++i )
-          tt &= vs.at( i );
+        signals[output] = _ntk.get_constant( type == "ALWAYS_TRUE" );
+        return;
       }
-      else if ( type == "NAND" )
-      {
-        tt = vs.at( 0u );
-        for ( auto i = 1u; i < inputs.size(); ++i )
-          tt &= vs.at( i );
+
+      signals[output] = _ntk.create_node( input_signals, gate_function( type, input_signals.size() ) );
+    }
+  }
+
+  /**
+   * Truth table of a gate of cirbo's basis (bench names as produced by `format_circuit`).
+   * Binary operators (XOR, GT, LNOT, ...) are given by 2-input truth tables, where
+   * variable 0 is the first operand.
+   */
+  static kitty::dynamic_truth_table gate_function( const std::string& type, std::size_t arity )
+  {
+    kitty::dynamic_truth_table tt( static_cast<int>( arity ) );
+
+    std::vector<kitty::dynamic_truth_table> vs( arity, tt );
+    for ( auto i = 0u; i < arity; ++i )
+      kitty::create_nth_var( vs[i], i );
+
+    auto const require_arity = [&]( std::size_t expected ) {
+      if ( arity != expected )
+        throw std::invalid_argument( "gate " + type + " expects " + std::to_string( expected ) + " operands" );
+    };
+
+    if ( type == "NOT" )
+    {
+      require_arity( 1u );
+      tt = ~vs.at( 0u );
+    }
+    else if ( type == "BUFF" || type == "IFF" )
+    {
+      require_arity( 1u );
+      tt = vs.at( 0u );
+    }
+    else if ( type == "AND" || type == "NAND" )
+    {
+      tt = vs.at( 0u );
+      for ( auto i = 1u; i < arity; ++i )
+        tt &= vs.at( i );
+      if ( type == "NAND" )
         tt = ~tt;
-      }
-      else if ( type == "OR" )
-      {
-        tt = vs.at( 0u );
-        for ( auto i = 1u; i < inputs.size(); ++i )
-          tt |= vs.at( i );
-      }
-      else if ( type == "NOR" )
-      {
-        tt = vs.at( 0u );
-        for ( auto i = 1u; i < inputs.size(); ++i )
-          tt |= vs.at( i );
+    }
+    else if ( type == "OR" || type == "NOR" )
+    {
+      tt = vs.at( 0u );
+      for ( auto i = 1u; i < arity; ++i )
+        tt |= vs.at( i );
+      if ( type == "NOR" )
         tt = ~tt;
-      }
-      else
-      {
-        assert( false && "unsupported gate type" );
-      }
-      signals[output] = _ntk.create_node( input_signals, tt );
     }
+    else if ( type == "XOR" || type == "NXOR" )
+    {
+      tt = vs.at( 0u );
+      for ( auto i = 1u; i < arity; ++i )
+        tt ^= vs.at( i );
+      if ( type == "NXOR" )
+        tt = ~tt;
+    }
+    else if ( type == "GT" )
+    {
+      require_arity( 2u );
+      tt = vs[0] & ~vs[1];
+    }
+    else if ( type == "LT" )
+    {
+      require_arity( 2u );
+      tt = ~vs[0] & vs[1];
+    }
+    else if ( type == "GEQ" )
+    {
+      require_arity( 2u );
+      tt = vs[0] | ~vs[1];
+    }
+    else if ( type == "LEQ" )
+    {
+      require_arity( 2u );
+      tt = ~vs[0] | vs[1];
+    }
+    else if ( type == "LIFF" || type == "RIFF" )
+    {
+      require_arity( 2u );
+      tt = vs[type == "LIFF" ? 0u : 1u];
+    }
+    else if ( type == "LNOT" || type == "RNOT" )
+    {
+      require_arity( 2u );
+      tt = ~vs[type == "LNOT" ? 0u : 1u];
+    }
+    else
+    {
+      throw std::invalid_argument( "unsupported gate type: " + type );
+    }
+    return tt;
   }
 
 mutable std::map<std::string, signal<Ntk>> signals;
@@ -159,6 +213,13 @@ inline std::map <std::string, std::vector<std::vector<std::string>>> enumerate_c
     std::map <std::string, std::vector<std::vector<std::string>>> node_cuts;
     for (auto signal: signals)
     {
+        // Constant gates of the circuit share nodes with reserved "gnd" and "vdd"
+        // signals, prefer circuit's labels for them.
+        if (signal.first == "gnd" || signal.first == "vdd")
+        {
+            index_to_node.emplace(signal.second, signal.first);
+            continue;
+        }
         index_to_node[signal.second] = signal.first;
     }
 
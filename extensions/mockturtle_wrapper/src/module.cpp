@@ -10,7 +10,10 @@
 
 #include <pybind11/pybind11.h>
 #include <pybind11/stl.h>
+#include "bit_program.hpp"
 #include "cut_enumerates.hpp"
+#include "optimization.hpp"
+#include "windows.hpp"
 
 #define STRINGIFY(x) #x
 #define MACRO_STRINGIFY(x) STRINGIFY(x)
@@ -20,6 +23,57 @@ namespace py = pybind11;
 PYBIND11_MODULE(mockturtle_wrapper, m) {
     m.doc() = "Example doc";
     m.def("enumerate_cuts", &enumerate_cuts, "Enumerates cuts.");
+    m.def("enumerate_windows", &enumerate_windows, "Enumerates reconvergence-driven windows.");
+    m.def(
+        "optimize_network",
+        &optimize_network,
+        "Optimizes circuit by a sequence of mockturtle algorithms.",
+        py::call_guard<py::gil_scoped_release>()
+    );
+
+    py::class_<bit_program>(m, "BitProgram", "Straight-line program evaluating a circuit on packed assignments.")
+        .def(
+            py::init<uint32_t, std::vector<program_gate_t> const&, std::vector<uint32_t> const&>(),
+            py::arg("input_size"),
+            py::arg("gates"),
+            py::arg("outputs")
+        )
+        .def_property_readonly("input_size", &bit_program::input_size)
+        .def_property_readonly("output_size", &bit_program::output_size)
+        .def(
+            "evaluate",
+            &bit_program::evaluate,
+            "Evaluates outputs on one assignment.",
+            py::arg("inputs"),
+            py::call_guard<py::gil_scoped_release>()
+        )
+        .def(
+            "evaluate_packed",
+            [](bit_program const& program, std::vector<std::string> const& inputs, std::size_t size) {
+                std::vector<std::string> outputs;
+                {
+                    py::gil_scoped_release release;
+                    outputs = program.evaluate_packed(inputs, size);
+                }
+                py::list result;
+                for (auto const& output: outputs)
+                {
+                    result.append(py::bytes(output));
+                }
+                return result;
+            },
+            "Evaluates outputs on assignments packed into little-endian bytes.",
+            py::arg("inputs"),
+            py::arg("size")
+        )
+        .def(
+            "count_satisfying",
+            &bit_program::count_satisfying,
+            "Counts assignments making all outputs true within a range of 64-assignment words.",
+            py::arg("first"),
+            py::arg("last"),
+            py::call_guard<py::gil_scoped_release>()
+        );
 
 #ifdef VERSION_INFO
     m.attr("__version__") = MACRO_STRINGIFY(VERSION_INFO);
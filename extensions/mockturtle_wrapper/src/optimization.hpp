@@ -0,0 +1,275 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+#include <mockturtle/mockturtle.hpp>
+#include <mockturtle/algorithms/balancing.hpp>
+#include <mockturtle/algorithms/balancing/esop_balancing.hpp>
+#include <mockturtle/algorithms/balancing/sop_balancing.hpp>
+#include <mockturtle/algorithms/cleanup.hpp>
+#include <mockturtle/algorithms/cut_rewriting.hpp>
+#include <mockturtle/algorithms/node_resynthesis/sop_factoring.hpp>
+#include <mockturtle/algorithms/node_resynthesis/xag_npn.hpp>
+#include <mockturtle/algorithms/refactoring.hpp>
+#include <mockturtle/algorithms/sim_resub.hpp>
+#include <mockturtle/networks/aig.hpp>
+#include <mockturtle/networks/xag.hpp>
+
+
+/**
+ * Gate of a circuit: its label, cirbo's gate type name and labels of operands.
+ */
+using circuit_gate_t = std::tuple<std::string, std::string, std::vector<std::string>>;
+
+/**
+ * Signal of an optimized network: index of a node and whether it is complemented.
+ * Node 0 is the constant false.
+ */
+using network_signal_t = std::pair<uint32_t, bool>;
+
+/**
+ * Gate of an optimized network: index of a node, its type (`AND` or `XOR`) and
+ * its operands.
+ */
+using network_gate_t = std::tuple<uint32_t, std::string, std::vector<network_signal_t>>;
+
+/**
+ * Optimized network: indices of input nodes (in order of circuit inputs), gates in
+ * topological order and output signals (in order of circuit outputs).
+ */
+using network_t = std::tuple<std::vector<uint32_t>, std::vector<network_gate_t>, std::vector<network_signal_t>>;
+
+
+/**
+ * Builds AIG or XAG from a circuit. AIG expresses XOR gates by three AND gates.
+ */
+template<class Ntk>
+Ntk build_network(
+    std::vector<std::string> const& inputs,
+    std::vector<circuit_gate_t> const& gates,
+    std::vector<std::string> const& outputs
+) {
+    using signal = typename Ntk::signal;
+
+    Ntk ntk;
+    std::map<std::string, signal> signals;
+    for (auto const& input: inputs)
+    {
+        signals[input] = ntk.create_pi();
+    }
+
+    for (auto const& [label, type, operand_labels]: gates)
+    {
+        std::vector<signal> operands;
+        for (auto const& operand: operand_labels)
+        {
+            operands.push_back(signals.at(operand));
+        }
+
+        auto const require_arity = [&](std::size_t expected) {
+            if (operands.size() != expected)
+            {
+                throw std::invalid_argument("gate " + label + " of type " + type + " expects " + std::to_string(expected) + " operands");
+            }
+        };
+
+        signal result;
+        if (type == "ALWAYS_TRUE" || type == "ALWAYS_FALSE")
+        {
+            result = ntk.get_constant(type == "ALWAYS_TRUE");
+        }
+        else if (type == "IFF" || type == "NOT")
+        {
+            require_arity(1u);
+            result = type == "IFF" ? operands[0] : !operands[0];
+        }
+        else if (type == "AND" || type == "NAND")
+        {
+            result = ntk.create_nary_and(operands);
+            result = type == "AND" ? result : !result;
+        }
+        else if (type == "OR" || type == "NOR")
+        {
+            result = ntk.create_nary_or(operands);
+            result = type == "OR" ? result : !result;
+        }
+        else if (type == "XOR" || type == "NXOR")
+        {
+            result = ntk.create_nary_xor(operands);
+            result = type == "XOR" ? result : !result;
+        }
+        else if (type == "GT" || type == "LEQ")
+        {
+            require_arity(2u);
+            result = ntk.create_and(operands[0], !operands[1]);
+            result = type == "GT" ? result : !result;
+        }
+        else if (type == "LT" || type == "GEQ")
+        {
+            require_arity(2u);
+            result = ntk.create_and(!operands[0], operands[1]);
+            result = type == "LT" ? result : !result;
+        }
+        else if (type == "LIFF" || type == "LNOT")
+        {
+            require_arity(2u);
+            result = type == "LIFF" ? operands[0] : !operands[0];
+        }
+        else if (type == "RIFF" || type == "RNOT")
+        {
+            require_arity(2u);
+            result = type == "RIFF" ? operands[1] : !operands[1];
+        }
+        else
+        {
+            throw std::invalid_argument("unsupported gate type: " + type);
+        }
+        signals[label] = result;
+    }
+
+    for (auto const& output: outputs)
+    {
+        ntk.create_po(signals.at(output));
+    }
+    return ntk;
+}
+
+
+/**
+ * Converts network into a list of gates. Network must be topologically sorted by node
+ * indices, which holds for a network produced by `cleanup_dangling`.
+ */
+template<class Ntk>
+network_t extract_network(Ntk const& ntk)
+{
+    auto const to_signal = [&](auto const& f) -> network_signal_t {
+        return {ntk.node_to_index(ntk.get_node(f)), ntk.is_complemented(f)};
+    };
+
+    network_t result;
+    auto& [inputs, gates, outputs] = result;
+    ntk.foreach_pi([&](auto const& n)
+    {
+        inputs.push_back(ntk.node_to_index(n));
+    });
+    ntk.foreach_gate([&](auto const& n)
+    {
+        std::vector<network_signal_t> operands;
+        ntk.foreach_fanin(n, [&](auto const& f)
+        {
+            operands.push_back(to_signal(f));
+        });
+        std::string type = "AND";
+        if constexpr (std::is_same_v<typename Ntk::base_type, mockturtle::xag_network>)
+        {
+            if (ntk.is_xor(n))
+            {
+                type = "XOR";
+            }
+        }
+        gates.emplace_back(ntk.node_to_index(n), type, std::move(operands));
+    });
+    ntk.foreach_po([&](auto const& f)
+    {
+        outputs.push_back(to_signal(f));
+    });
+    return result;
+}
+
+
+/**
+ * Runs a single mockturtle optimization algorithm on the network.
+ *
+ * @param ntk AIG or XAG network.
+ * @param algorithm one of `rewrite` (cut rewriting with NPN database of optimal 4-input
+ * networks), `refactor` (refactoring with SOP factoring), `resub` (simulation-guided
+ * resubstitution) and `balance` (SOP balancing for AIG and ESOP balancing for XAG).
+ * @return optimized network without dangling nodes.
+ */
+template<class Ntk>
+Ntk run_algorithm(Ntk ntk, std::string const& algorithm)
+{
+    constexpr bool is_xag = std::is_same_v<Ntk, mockturtle::xag_network>;
+
+    if (algorithm == "rewrite")
+    {
+        using database_t = std::conditional_t<
+            is_xag,
+            mockturtle::xag_npn_resynthesis<Ntk, mockturtle::xag_network, mockturtle::xag_npn_db_kind::xag_complete>,
+            mockturtle::xag_npn_resynthesis<Ntk, mockturtle::xag_network, mockturtle::xag_npn_db_kind::aig_complete>
+        >;
+        database_t resyn;
+        mockturtle::cut_rewriting_params ps;
+        ps.cut_enumeration_ps.cut_size = 4;
+        mockturtle::cut_rewriting_with_compatibility_graph(ntk, resyn, ps);
+    }
+    else if (algorithm == "refactor")
+    {
+        mockturtle::sop_factoring<Ntk> resyn;
+        mockturtle::refactoring(ntk, resyn);
+    }
+    else if (algorithm == "resub")
+    {
+        mockturtle::sim_resubstitution(ntk);
+    }
+    else if (algorithm == "balance")
+    {
+        if constexpr (is_xag)
+        {
+            ntk = mockturtle::balancing(ntk, {mockturtle::esop_rebalancing<Ntk>{}});
+        }
+        else
+        {
+            ntk = mockturtle::balancing(ntk, {mockturtle::sop_rebalancing<Ntk>{}});
+        }
+    }
+    else
+    {
+        throw std::invalid_argument("unsupported algorithm: " + algorithm);
+    }
+    return mockturtle::cleanup_dangling(ntk);
+}
+
+
+/**
+ * Optimizes a circuit by a sequence of mockturtle algorithms.
+ *
+ * Circuit is converted into XAG if `keep_xor` is set and into AIG otherwise, so XOR
+ * gates survive optimization only in the former case.
+ *
+ * @param inputs labels of circuit inputs.
+ * @param gates circuit gates in topological order (inputs excluded).
+ * @param outputs labels of circuit outputs.
+ * @param script names of algorithms to run one after another (see `run_algorithm`).
+ * @param keep_xor whether result may contain XOR gates.
+ * @return optimized network.
+ */
+inline network_t optimize_network(
+    std::vector<std::string> const& inputs,
+    std::vector<circuit_gate_t> const& gates,
+    std::vector<std::string> const& outputs,
+    std::vector<std::string> const& script,
+    bool keep_xor
+) {
+    auto const optimize = [&](auto ntk) -> network_t {
+        ntk = mockturtle::cleanup_dangling(ntk);
+        for (auto const& algorithm: script)
+        {
+            ntk = run_algorithm(ntk, algorithm);
+        }
+        return extract_network(ntk);
+    };
+
+    if (keep_xor)
+    {
+        return optimize(build_network<mockturtle::xag_network>(inputs, gates, outputs));
+    }
+    return optimize(build_network<mockturtle::aig_network>(inputs, gates, outputs));
+}
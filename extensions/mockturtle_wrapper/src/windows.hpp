@@ -0,0 +1,197 @@
+#pragma once
+
+#include <cstdint>
+#include <map>
+#include <set>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <mockturtle/mockturtle.hpp>
+#include <mockturtle/networks/klut.hpp>
+#include <mockturtle/views/fanout_view.hpp>
+#include <lorina/bench.hpp>
+
+#include "cut_enumerates.hpp"
+
+
+/**
+ * Window of a network: its leaves (inputs) and gates, both given by circuit's labels.
+ * Gates are listed in topological order.
+ */
+using window_t = std::pair<std::vector<std::string>, std::vector<std::string>>;
+
+
+/**
+ * Enumerates reconvergence-driven windows of the circuit (one window per gate).
+ *
+ * The window of a pivot gate is grown from the pivot towards the inputs: on each step
+ * the leaf whose expansion adds the smallest number of new leaves is moved inside the
+ * window, so reconvergent paths are closed first. Expansion stops when no leaf can be
+ * moved without violating limits on number of leaves, number of (non unary) gates and
+ * number of window outputs (gates used outside of the window or marked as outputs).
+ *
+ * @param circuit circuit in bench format (as produced by `format_circuit`).
+ * @param max_inputs maximum number of window leaves.
+ * @param max_gates maximum number of window gates with two or more operands.
+ * @param max_outputs maximum number of window outputs.
+ * @return list of distinct windows with at least two leaves and two gates.
+ * @throws std::invalid_argument if the circuit cannot be read.
+ */
+inline std::vector<window_t> enumerate_windows(const std::string &circuit, int max_inputs, int max_gates, int max_outputs) {
+    using node = mockturtle::klut_network::node;
+
+    mockturtle::klut_network klut;
+    std::map<std::string, mockturtle::klut_network::signal> signals;
+    {
+        // Reader creates primary outputs on destruction.
+        auto bench_reader = mockturtle::public_bench_reader(klut);
+        std::istringstream in(circuit);
+        auto const result = lorina::read_bench(in, bench_reader);
+        if (result != lorina::return_code::success)
+        {
+            throw std::invalid_argument("circuit is not a valid bench description");
+        }
+        signals = bench_reader.signals;
+    }
+
+    std::map<uint32_t, std::string> index_to_node;
+    for (auto signal: signals)
+    {
+        if (signal.first == "gnd" || signal.first == "vdd")
+        {
+            index_to_node.emplace(signal.second, signal.first);
+            continue;
+        }
+        index_to_node[signal.second] = signal.first;
+    }
+
+    mockturtle::fanout_view fanout_klut{klut};
+
+    std::set<node> po_nodes;
+    klut.foreach_po([&](auto const& f)
+    {
+        po_nodes.insert(klut.get_node(f));
+    });
+
+    auto const gate_cost = [&](node n) -> int
+    {
+        return klut.fanin_size(n) > 1u ? 1 : 0;
+    };
+
+    auto const count_outputs = [&](std::set<node> const& gates) -> int
+    {
+        int outputs = 0;
+        for (auto n: gates)
+        {
+            bool is_output = po_nodes.count(n) > 0;
+            fanout_klut.foreach_fanout(n, [&](auto const& user)
+            {
+                if (gates.count(user) == 0)
+                {
+                    is_output = true;
+                }
+            });
+            outputs += is_output;
+        }
+        return outputs;
+    };
+
+    std::set<std::vector<node>> seen;
+    std::vector<window_t> windows;
+
+    klut.foreach_gate([&](auto const& pivot)
+    {
+        std::set<node> gates{pivot};
+        std::set<node> leaves;
+        klut.foreach_fanin(pivot, [&](auto const& f)
+        {
+            leaves.insert(klut.get_node(f));
+        });
+        int size = gate_cost(pivot);
+        if (size > max_gates || static_cast<int>(leaves.size()) > max_inputs)
+        {
+            return;
+        }
+
+        while (true)
+        {
+            bool found = false;
+            node best{};
+            int best_cost = 0;
+            for (auto leaf: leaves)
+            {
+                if (klut.is_pi(leaf) || klut.is_constant(leaf) || size + gate_cost(leaf) > max_gates)
+                {
+                    continue;
+                }
+
+                std::set<node> new_leaves;
+                klut.foreach_fanin(leaf, [&](auto const& f)
+                {
+                    auto const fanin = klut.get_node(f);
+                    if (gates.count(fanin) == 0 && leaves.count(fanin) == 0)
+                    {
+                        new_leaves.insert(fanin);
+                    }
+                });
+                int const cost = static_cast<int>(new_leaves.size()) - 1;
+                if (static_cast<int>(leaves.size()) + cost > max_inputs || (found && cost >= best_cost))
+                {
+                    continue;
+                }
+
+                gates.insert(leaf);
+                bool const fits = count_outputs(gates) <= max_outputs;
+                gates.erase(leaf);
+                if (fits)
+                {
+                    found = true;
+                    best = leaf;
+                    best_cost = cost;
+                }
+            }
+            if (!found)
+            {
+                break;
+            }
+
+            leaves.erase(best);
+            gates.insert(best);
+            size += gate_cost(best);
+            klut.foreach_fanin(best, [&](auto const& f)
+            {
+                auto const fanin = klut.get_node(f);
+                if (gates.count(fanin) == 0)
+                {
+                    leaves.insert(fanin);
+                }
+            });
+        }
+
+        if (leaves.size() < 2u || gates.size() < 2u)
+        {
+            return;
+        }
+        std::vector<node> key(gates.begin(), gates.end());
+        if (!seen.insert(key).second)
+        {
+            return;
+        }
+
+        window_t window;
+        for (auto leaf: leaves)
+        {
+            window.first.push_back(index_to_node[klut.node_to_index(leaf)]);
+        }
+        for (auto gate: gates)
+        {
+            window.second.push_back(index_to_node[klut.node_to_index(gate)]);
+        }
+        windows.push_back(std::move(window));
+    });
+
+    return windows;
+}
@@ -1,6 +1,7 @@
 import collections
 import copy
 import itertools
+import pickle
 
 import pytest
 
@@ -585,6 +586,37 @@ def test_block():
     assert manipulateC9.outputs == ['C1@C', '1@C', '1@C']
 
 
+def test_connect_circuit_keeps_users_consistent():
+    C0 = Circuit.bare_circuit(2, prefix='x')
+    C0.add_gate(Gate('C', OR, ('x0', 'x1')))
+    C0.mark_as_output('C')
+
+    C1 = Circuit.bare_circuit(2, prefix='y')
+    C1.add_gate(Gate('D', AND, ('y0', 'y1')))
+    C1.mark_as_output('D')
+
+    C0.connect_circuit(C1, ['x0'], ['D'], right_connect=True, name='C1')
+    assert C0.get_gate('x0') == Gate('x0', AND, ('C1@y0', 'C1@y1'))
+    assert C0.get_gate_users('C1@y0') == ['x0']
+    assert C0.inputs == ['x1', 'C1@y0', 'C1@y1']
+    assert C0.outputs == ['C']
+    assert [g.label for g in C0.top_sort()][0] == 'C'
+
+
+def test_connect_circuit_with_existing_label():
+    C0 = Circuit.bare_circuit(2, prefix='x')
+    C0.add_gate(Gate('C', OR, ('x0', 'x1')))
+    C0.mark_as_output('C')
+    C1 = Circuit.bare_circuit(2, prefix='y')
+    C1.add_gate(Gate('C', AND, ('y0', 'y1')))
+    C1.mark_as_output('C')
+
+    expected = copy.copy(C0)
+    with pytest.raises(CircuitValidationError):
+        C0.connect_circuit(C1, ['x0'], ['y0'])
+    assert C0 == expected
+
+
 def test_block2():
     C0 = Circuit()
     C0.add_gate(Gate('A', INPUT))
@@ -2076,6 +2108,88 @@ def test_get_truth_table():
     ]
 
 
+def test_get_truth_table_of_wide_circuit():
+    instance = Circuit.bare_circuit(18, prefix='x')
+    instance.add_gate(Gate('and', AND, ('x0', 'x17')))
+    instance.add_gate(Gate('xor', XOR, ('and', 'x9')))
+    instance.add_gate(Gate('not', NOT, ('x3',)))
+    instance.mark_as_output('xor')
+    instance.mark_as_output('not')
+
+    truth_table = instance.get_truth_table()
+    assert len(truth_table) == 2
+    assert all(len(row) == 2**18 for row in truth_table)
+    for j in (0, 1, 2**16 - 1, 2**16, 2**17 + 2**8 + 1, 2**18 - 1):
+        assignment = [bool((j >> (17 - i)) & 1) for i in range(18)]
+        assert [row[j] for row in truth_table] == instance.evaluate(assignment)
+
+
+def test_modification_invalidates_cached_data():
+    instance = Circuit.bare_circuit(2, prefix='x')
+    instance.add_gate(Gate('C', AND, ('x0', 'x1')))
+    instance.mark_as_output('C')
+
+    assert instance.get_truth_table() == [[False, False, False, True]]
+    assert instance.get_gate_levels() == {'x0': 0, 'x1': 0, 'C': 1}
+    assert instance.get_fanout_counts() == {'x0': 1, 'x1': 1, 'C': 0}
+    assert [g.label for g in instance.top_sort()] == ['C', 'x1', 'x0']
+
+    version = instance.version
+    instance.get_truth_table()[0][0] = True
+    instance.add_gate(Gate('D', NOT, ('C',)))
+    assert instance.version > version
+    assert instance.get_truth_table() == [[False, False, False, True]]
+    assert instance.get_gate_levels()['D'] == 2
+    assert instance.get_fanout_counts()['C'] == 1
+    assert [g.label for g in instance.top_sort(inverse=True)][-1] == 'D'
+
+    instance.set_outputs(['D'])
+    assert instance.get_truth_table() == [[True, True, True, False]]
+
+    instance.rename_gate('D', 'E')
+    assert instance.get_gate_levels() == {'x0': 0, 'x1': 0, 'C': 1, 'E': 2}
+    assert [g.label for g in instance.top_sort()][0] == 'E'
+
+    instance.order_inputs(['x1', 'x0'])
+    instance.remove_gate('E')
+    instance.set_outputs(['C', 'x1'])
+    assert instance.get_truth_table() == [
+        [False, False, False, True],
+        [False, False, True, True],
+    ]
+    assert instance.get_fanout_counts() == {'x0': 1, 'x1': 1, 'C': 0}
+
+
+def test_copies_dont_keep_cached_data():
+    instance = Circuit.bare_circuit(3, prefix='x')
+    instance.add_gate(Gate('C', OR, ('x0', 'x1', 'x2')))
+    instance.mark_as_output('C')
+    instance.get_gate_levels()
+    list(instance.top_sort())
+    assert instance._cache
+
+    for copied in (copy.deepcopy(instance), pickle.loads(pickle.dumps(instance))):
+        assert copied._cache == {}
+        assert copied == instance
+        assert copied.version == instance.version
+        assert copied.get_gate_levels() == instance.get_gate_levels()
+        assert copied.get_truth_table() == instance.get_truth_table()
+    assert instance._cache
+
+
+def test_queries_do_not_modify_circuit():
+    instance = Circuit.bare_circuit(3, prefix='x')
+    instance.add_gate(Gate('C', OR, ('x0', 'x1', 'x2')))
+    instance.mark_as_output('C')
+
+    version = instance.version
+    list(instance.top_sort())
+    instance.get_truth_table()
+    instance.get_gate_levels()
+    instance.is_monotone()
+    assert instance.version == version
+
+
 def test_circuit_gate():
     instance = Circuit()
 
@@ -0,0 +1,134 @@
+import itertools
+import pickle
+import random
+
+import pytest
+
+import cirbo.core.circuit.compiled as compiled_module
+from cirbo.core.circuit import (
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+    AND,
+    Circuit,
+    Gate,
+    GEQ,
+    GT,
+    IFF,
+    LEQ,
+    LIFF,
+    LNOT,
+    LT,
+    NAND,
+    NOR,
+    NOT,
+    NXOR,
+    OR,
+    RIFF,
+    RNOT,
+    XOR,
+)
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
+
+
+def _all_gates_circuit() -> Circuit:
+    circuit = Circuit.bare_circuit(3, prefix='x')
+    binary = [GEQ, GT, LEQ, LIFF, LNOT, LT, RIFF, RNOT]
+    for i, gate_type in enumerate(binary):
+        circuit.add_gate(Gate(f'b{i}', gate_type, ('x0', 'x1')))
+    for i, gate_type in enumerate([AND, NAND, OR, NOR, XOR, NXOR]):
+        circuit.add_gate(Gate(f'm{i}', gate_type, ('x0', 'x1', 'x2')))
+    circuit.add_gate(Gate('not', NOT, ('x2',)))
+    circuit.add_gate(Gate('iff', IFF, ('x1',)))
+    circuit.add_gate(Gate('true', ALWAYS_TRUE, ()))
+    circuit.add_gate(Gate('false', ALWAYS_FALSE, ()))
+    circuit.add_gate(Gate('deep', AND, ('m4', 'not', 'true')))
+    circuit.set_outputs(
+        [f'b{i}' for i in range(len(binary))]
+        + [f'm{i}' for i in range(6)]
+        + ['not', 'iff', 'true', 'false', 'deep', 'x0', 'deep']
+    )
+    return circuit
+
+
+@pytest.fixture(params=['native', 'python'])
+def backend(request, monkeypatch):
+    if request.param == 'python':
+        monkeypatch.setattr(compiled_module, '_NativeProgram', None)
+    elif compiled_module._NativeProgram is None:
+        pytest.skip('package is built without extensions')
+    return request.param
+
+
+@pytest.mark.parametrize('circuit', [_all_gates_circuit(), generate_sum_n_bits(5)])
+def test_evaluate(circuit: Circuit, backend: str):
+    compiled = circuit.compile()
+    assert compiled.input_size == circuit.input_size
+    assert compiled.output_size == circuit.output_size
+
+    assignments = list(itertools.product((False, True), repeat=circuit.input_size))
+    expected = [circuit.evaluate(assignment) for assignment in assignments]
+    assert [compiled.evaluate(assignment) for assignment in assignments] == expected
+    assert compiled.evaluate_batch(assignments) == expected
+
+
+def test_evaluate_packed(backend: str):
+    circuit = generate_sum_n_bits(7)
+    compiled = circuit.compile()
+    rng = random.Random(1)
+    size = 100
+    vectors = [rng.getrandbits(size) for _ in range(circuit.input_size)]
+
+    outputs = compiled.evaluate_packed(vectors, size)
+    for k in range(size):
+        assignment = [bool((vector >> k) & 1) for vector in vectors]
+        assert [bool((output >> k) & 1) for output in outputs] == circuit.evaluate(
+            assignment
+        )
+    assert all(output >> size == 0 for output in outputs)
+    assert (
+        compiled.evaluate_packed([vector | (1 << size) for vector in vectors], size)
+        == outputs
+    )
+
+
+def test_compiled_circuit_doesnt_follow_modification():
+    circuit = Circuit.bare_circuit(2, prefix='x')
+    circuit.add_gate(Gate('g', AND, ('x0', 'x1')))
+    circuit.mark_as_output('g')
+
+    compiled = circuit.compile()
+    circuit.add_gate(Gate('h', NOT, ('g',)))
+    circuit.set_outputs(['h'])
+    assert compiled.evaluate([True, True]) == [True]
+    assert circuit.compile().evaluate([True, True]) == [False]
+
+
+def test_pickle_after_compile():
+    circuit = generate_sum_n_bits(3)
+    compiled = circuit.compile()
+    assignments = list(itertools.product((False, True), repeat=circuit.input_size))
+
+    restored = pickle.loads(pickle.dumps(circuit))
+    assert restored.get_truth_table() == circuit.get_truth_table()
+    assert restored.compile().evaluate_batch(assignments) == compiled.evaluate_batch(
+        assignments
+    )
+
+
+def test_constant_circuit_without_inputs(backend: str):
+    circuit = Circuit()
+    circuit.add_gate(Gate('t', ALWAYS_TRUE, ()))
+    circuit.mark_as_output('t')
+    compiled = circuit.compile()
+
+    assert compiled.evaluate([]) == [True]
+    assert compiled.evaluate_batch([[], []]) == [[True], [True]]
+    assert compiled.evaluate_batch([]) == []
+
+
+def test_wrong_number_of_inputs(backend: str):
+    compiled = generate_sum_n_bits(2).compile()
+    with pytest.raises(ValueError):
+        compiled.evaluate([True])
+    with pytest.raises(ValueError):
+        compiled.evaluate_batch([[True, False], [True]])
@@ -0,0 +1,126 @@
+import pytest
+
+from cirbo.core.circuit import AND, Circuit, Gate, HierarchicalCircuit, NOT, XOR
+from cirbo.core.circuit.exceptions import CircuitValidationError
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
+
+
+def _chain_of_adders(number: int) -> HierarchicalCircuit:
+    """Sums inputs one by one with the same instantiated adder."""
+    adder = generate_sum_n_bits(2)
+    circuit = HierarchicalCircuit()
+    circuit.add_inputs([f'x{i}' for i in range(number + 1)])
+    low, high = 'x0', None
+    for i in range(number):
+        low, carry = circuit.add_instance(f'a{i}', adder, [low, f'x{i + 1}'])
+        if high is None:
+            high = carry
+        else:
+            circuit.emplace_gate(f'h{i}', XOR, (high, carry))
+            high = f'h{i}'
+    circuit.set_outputs([low, high])
+    return circuit
+
+
+def test_instances_share_definition():
+    circuit = _chain_of_adders(5)
+    assert len(circuit.instances) == 5
+    assert len({id(instance.definition) for instance in circuit.instances}) == 1
+    low, high = circuit.instances[0].definition.outputs
+    assert circuit.instances[1].inputs == (f'a0@{low}', 'x2')
+    assert circuit.instances[1].outputs == (f'a1@{low}', f'a1@{high}')
+
+
+@pytest.mark.parametrize('number', [1, 3, 6])
+def test_flatten(number: int):
+    circuit = _chain_of_adders(number)
+    flat = circuit.flatten()
+
+    assert flat.size == circuit.size
+    assert flat.inputs == circuit.inputs
+    assert flat.outputs == circuit.outputs
+    assert set(flat.blocks) == {f'a{i}' for i in range(number)}
+    assert flat.get_truth_table() == circuit.get_truth_table()
+    for j, values in enumerate(zip(*flat.get_truth_table())):
+        weight = bin(j).count('1')
+        assert list(values) == [bool(weight & 1), bool(weight & 2)]
+
+
+def test_evaluate_and_simulate():
+    circuit = _chain_of_adders(3)
+    flat = circuit.flatten()
+    assert circuit.evaluate([True, True, False, True]) == [True, True]
+    assert circuit.simulate([0b01, 0b11, 0b00, 0b11], 0b11) == [0b01, 0b11]
+    assert flat.evaluate([True, True, False, True]) == [True, True]
+
+
+def test_pass_through_output():
+    definition = Circuit.bare_circuit(2, prefix='y')
+    definition.add_gate(Gate('n', NOT, ('y1',)))
+    definition.set_outputs(['y0', 'n'])
+
+    circuit = HierarchicalCircuit()
+    circuit.add_inputs(['a', 'b'])
+    assert circuit.add_instance('i', definition, ['b', 'a']) == ['b', 'i@n']
+    circuit.emplace_gate('g', AND, ('b', 'i@n'))
+    circuit.set_outputs(['g', 'i@n'])
+
+    assert circuit.get_truth_table() == [
+        [False, True, False, False],
+        [True, True, False, False],
+    ]
+    assert circuit.flatten().get_truth_table() == circuit.get_truth_table()
+
+
+def test_invalid_construction():
+    adder = generate_sum_n_bits(2)
+    circuit = HierarchicalCircuit()
+    circuit.add_inputs(['a', 'b'])
+    with pytest.raises(CircuitValidationError):
+        circuit.add_inputs(['a'])
+    with pytest.raises(CircuitValidationError):
+        circuit.add_instance('i', adder, ['a'])
+    with pytest.raises(CircuitValidationError):
+        circuit.add_instance('i', adder, ['a', 'c'])
+    with pytest.raises(CircuitValidationError):
+        circuit.emplace_gate('g', AND, ('a', 'c'))
+
+    low, _ = circuit.add_instance('i', adder, ['a', 'b'])
+    with pytest.raises(CircuitValidationError):
+        circuit.add_instance('i', adder, ['a', 'b'])
+    with pytest.raises(CircuitValidationError):
+        circuit.emplace_gate(low, AND, ('a', 'b'))
+
+
+def test_instance_names_and_signals_share_namespace():
+    adder = generate_sum_n_bits(2)
+    circuit = HierarchicalCircuit()
+    circuit.add_inputs(['a', 'b'])
+    circuit.add_instance('i', adder, ['a', 'b'])
+    with pytest.raises(CircuitValidationError):
+        circuit.emplace_gate('i', AND, ('a', 'b'))
+    with pytest.raises(CircuitValidationError):
+        circuit.add_inputs(['i'])
+    with pytest.raises(CircuitValidationError):
+        circuit.add_instance('a', adder, ['a', 'b'])
+    assert len(circuit.instances) == 1
+    assert circuit.inputs == ['a', 'b']
+    assert not circuit.has_signal('i')
+
+
+def test_modified_definition():
+    definition = Circuit.bare_circuit(2, prefix='y')
+    definition.add_gate(Gate('g', AND, ('y0', 'y1')))
+    definition.mark_as_output('g')
+
+    circuit = HierarchicalCircuit()
+    circuit.add_inputs(['a', 'b'])
+    circuit.add_instance('i', definition, ['a', 'b'])
+    circuit.set_outputs(['i@g'])
+    assert circuit.evaluate([True, True]) == [True]
+
+    definition.add_gate(Gate('h', NOT, ('g',)))
+    with pytest.raises(CircuitValidationError):
+        circuit.flatten()
+    with pytest.raises(CircuitValidationError):
+        circuit.evaluate([True, True])
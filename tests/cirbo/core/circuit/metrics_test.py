@@ -0,0 +1,113 @@
+import dataclasses
+
+from cirbo.core.circuit import (
+    ALWAYS_TRUE,
+    AND,
+    Circuit,
+    Gate,
+    INPUT,
+    NOT,
+    OR,
+    XOR,
+)
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
+
+
+def _example_circuit() -> Circuit:
+    # x0 is a stem, paths from which reconverge at 'and'; 'or' is not reconvergent.
+    circuit = Circuit.bare_circuit(3, prefix='x')
+    circuit.add_gate(Gate('not', NOT, ('x0',)))
+    circuit.add_gate(Gate('xor', XOR, ('x0', 'x1')))
+    circuit.add_gate(Gate('and', AND, ('not', 'xor')))
+    circuit.add_gate(Gate('one', ALWAYS_TRUE, ()))
+    circuit.add_gate(Gate('or', OR, ('and', 'x2', 'one')))
+    circuit.set_outputs(['or', 'not'])
+    return circuit
+
+
+def test_structural_metrics():
+    metrics = _example_circuit().get_structural_metrics(reconvergence=True)
+
+    assert metrics.gate_counts == {
+        INPUT: 3,
+        NOT: 1,
+        XOR: 1,
+        AND: 1,
+        ALWAYS_TRUE: 1,
+        OR: 1,
+    }
+    assert metrics.levels == {
+        'x0': 0,
+        'x1': 0,
+        'x2': 0,
+        'not': 1,
+        'xor': 1,
+        'and': 2,
+        'one': 0,
+        'or': 3,
+    }
+    assert metrics.depth == 3
+    assert metrics.critical_path == ['x0', 'xor', 'and', 'or']
+    assert metrics.critical_path_length == 3
+    assert metrics.fanout_histogram == {0: 1, 1: 6, 2: 1}
+    assert metrics.fanout_stems == 1
+    assert metrics.reconvergent_gates == 1
+
+
+def test_repeated_operand_is_reconvergent():
+    circuit = Circuit.bare_circuit(1, prefix='x')
+    circuit.add_gate(Gate('g', AND, ('x0', 'x0')))
+    circuit.mark_as_output('g')
+
+    metrics = circuit.get_structural_metrics(reconvergence=True)
+    assert metrics.fanout_histogram == {2: 1, 0: 1}
+    assert metrics.fanout_stems == 1
+    assert metrics.reconvergent_gates == 1
+
+
+def test_reconvergence_is_opt_in():
+    circuit = _example_circuit()
+    metrics = circuit.get_structural_metrics()
+    assert metrics.reconvergent_gates is None
+    assert metrics.fanout_stems == 1
+
+    full = circuit.get_structural_metrics(reconvergence=True)
+    assert full.reconvergent_gates == 1
+    assert dataclasses.replace(full, reconvergent_gates=None) == metrics
+    assert circuit.get_structural_metrics() is metrics
+
+
+def test_empty_circuit():
+    metrics = Circuit().get_structural_metrics()
+    assert metrics.gate_counts == {}
+    assert metrics.depth == 0
+    assert metrics.critical_path == []
+    assert metrics.critical_path_length == 0
+
+
+def test_metrics_follow_modifications():
+    circuit = _example_circuit()
+    metrics = circuit.get_structural_metrics()
+    assert circuit.get_structural_metrics() is metrics
+    assert circuit.gates_number() == 3
+
+    circuit.add_gate(Gate('top', AND, ('or', 'x1')))
+    circuit.set_outputs(['top'])
+    assert circuit.gates_number() == 4
+    assert circuit.gates_number([INPUT]) == 6
+    assert circuit.get_structural_metrics().depth == 4
+    assert circuit.get_structural_metrics().critical_path[-1] == 'top'
+
+
+def test_adder_depth():
+    circuit = generate_sum_n_bits(16)
+    metrics = circuit.get_structural_metrics()
+
+    levels = circuit.get_gate_levels()
+    assert metrics.levels == levels
+    assert metrics.depth == max(levels[output] for output in circuit.outputs)
+    assert sum(metrics.gate_counts.values()) == circuit.size
+    assert sum(metrics.fanout_histogram.values()) == circuit.size
+    assert metrics.critical_path[0] in circuit.inputs
+    for operand, user in zip(metrics.critical_path, metrics.critical_path[1:]):
+        assert operand in circuit.get_gate(user).operands
@@ -0,0 +1,140 @@
+import pathlib
+import random
+
+import pytest
+from cirbo.core.boolean_function import Function
+from cirbo.core.circuit import AND, Circuit, Gate, INPUT, NOT, OR, XOR
+from cirbo.core.exceptions import PackedTruthTableFormatError
+from cirbo.core.packed_truth_table import (
+    _CHUNK_INPUTS,
+    PackedTruthTable,
+    write_packed_truth_table,
+)
+from cirbo.core.truth_table import TruthTable
+
+from tests.cirbo.core.truth_table_test import generate_random_truth_table
+from tests.cirbo.sat.cnf.generator_utils import generate_random_circuit
+
+
+def _check_same_properties(packed: PackedTruthTable, expected: Function):
+    assert packed.input_size == expected.input_size
+    assert packed.output_size == expected.output_size
+    assert packed.get_truth_table() == expected.get_truth_table()
+    assert packed.is_constant() == expected.is_constant()
+    assert packed.is_monotone() == expected.is_monotone()
+    assert packed.is_monotone(inverse=True) == expected.is_monotone(inverse=True)
+    assert packed.is_symmetric() == expected.is_symmetric()
+    for output_index in range(expected.output_size):
+        assert packed.is_constant_at(output_index) == expected.is_constant_at(
+            output_index
+        )
+        assert packed.is_symmetric_at(output_index) == expected.is_symmetric_at(
+            output_index
+        )
+        assert packed.get_significant_inputs_of(
+            output_index
+        ) == expected.get_significant_inputs_of(output_index)
+        for input_index in range(expected.input_size):
+            assert packed.is_output_equal_to_input(
+                output_index, input_index
+            ) == expected.is_output_equal_to_input(output_index, input_index)
+            assert packed.is_output_equal_to_input_negation(
+                output_index, input_index
+            ) == expected.is_output_equal_to_input_negation(output_index, input_index)
+    assert packed.find_negations_to_make_symmetric(
+        list(range(expected.output_size))
+    ) == expected.find_negations_to_make_symmetric(list(range(expected.output_size)))
+
+
+def test_implements_protocol():
+    assert isinstance(PackedTruthTable, Function)
+
+
+@pytest.mark.parametrize('seed', range(10))
+@pytest.mark.parametrize('input_size', [1, 2, 3, 5])
+def test_random_truth_table(tmp_path: pathlib.Path, seed: int, input_size: int):
+    random.seed(seed)
+    truth_table = TruthTable(generate_random_truth_table(input_size, 2))
+    write_packed_truth_table(truth_table, tmp_path / 'tt.bin')
+    with PackedTruthTable(tmp_path / 'tt.bin') as packed:
+        _check_same_properties(packed, truth_table)
+
+
+@pytest.mark.parametrize('seed', range(10))
+def test_random_circuit(tmp_path: pathlib.Path, seed: int):
+    random.seed(seed)
+    circuit = generate_random_circuit(inputs=6, gates=20, outputs=3)
+    write_packed_truth_table(circuit, tmp_path / 'tt.bin')
+    with PackedTruthTable(tmp_path / 'tt.bin') as packed:
+        _check_same_properties(packed, TruthTable(circuit.get_truth_table()))
+        for _ in range(10):
+            inputs = [random.choice([False, True]) for _ in range(6)]
+            assert packed.evaluate(inputs) == circuit.evaluate(inputs)
+
+
+@pytest.mark.parametrize(
+    'truth_table',
+    [
+        ["0000", "1111"],
+        ["0001", "0111", "0011", "0101"],
+        ["0110", "1001", "1000", "1110"],
+    ],
+)
+def test_special_truth_tables(tmp_path: pathlib.Path, truth_table: list[str]):
+    expected = TruthTable([list(output) for output in truth_table])
+    write_packed_truth_table(expected, tmp_path / 'tt.bin')
+    with PackedTruthTable(tmp_path / 'tt.bin') as packed:
+        _check_same_properties(packed, expected)
+
+
+def _wide_circuit(input_size: int) -> Circuit:
+    # Outputs: parity of all inputs, first input, AND of the last two inputs, OR of
+    # the first and the last inputs and negation of the first input.
+    circuit = Circuit()
+    inputs = [f'x{i}' for i in range(input_size)]
+    for label in inputs:
+        circuit.add_gate(Gate(label, INPUT))
+    circuit.add_gate(Gate('parity', XOR, tuple(inputs)))
+    circuit.add_gate(Gate('and', AND, (inputs[-2], inputs[-1])))
+    circuit.add_gate(Gate('or', OR, (inputs[0], inputs[-1])))
+    circuit.add_gate(Gate('not', NOT, (inputs[0],)))
+    circuit.set_outputs(['parity', inputs[0], 'and', 'or', 'not'])
+    return circuit
+
+
+@pytest.mark.parametrize('workers', [1, 3])
+def test_several_chunks(tmp_path: pathlib.Path, workers: int):
+    input_size = _CHUNK_INPUTS + 2
+    path = tmp_path / 'tt.bin'
+    write_packed_truth_table(_wide_circuit(input_size), path, workers=workers)
+    assert path.stat().st_size == 64 + 5 * 2 ** (input_size - 3)
+
+    with PackedTruthTable(path) as packed:
+        assert not packed.is_constant()
+        assert packed.is_symmetric_at(0)
+        assert not packed.is_symmetric_at(3)
+        assert packed.is_symmetric_at(2) is False
+        assert packed.is_monotone_at(1)
+        assert packed.is_monotone_at(4, inverse=True)
+        assert not packed.is_monotone_at(3)
+        assert packed.is_output_equal_to_input(1, 0)
+        assert packed.is_output_equal_to_input_negation(4, 0)
+        assert not packed.is_output_equal_to_input(0, 0)
+        assert packed.get_significant_inputs_of(0) == list(range(input_size))
+        assert packed.get_significant_inputs_of(2) == [input_size - 2, input_size - 1]
+        assert packed.get_significant_inputs_of(3) == [0, input_size - 1]
+        assert packed.evaluate_at([True] * input_size, 3)
+        assert packed.evaluate_at([False] * input_size, 4)
+
+
+def test_bad_file(tmp_path: pathlib.Path):
+    path = tmp_path / 'tt.bin'
+    path.write_bytes(b'not a truth table')
+    with pytest.raises(PackedTruthTableFormatError):
+        PackedTruthTable(path)
+
+    write_packed_truth_table(TruthTable([[False, True]]), path)
+    with open(path, 'ab') as file:
+        file.write(b'\0')
+    with pytest.raises(PackedTruthTableFormatError):
+        PackedTruthTable(path)
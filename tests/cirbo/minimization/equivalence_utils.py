@@ -0,0 +1,12 @@
+from cirbo.core.circuit import Circuit
+from cirbo.sat.miter import build_miter
+from cirbo.sat.sat import is_circuit_satisfiable
+
+
+__all__ = [
+    'assert_equivalent',
+]
+
+
+def assert_equivalent(lhs: Circuit, rhs: Circuit):
+    assert not is_circuit_satisfiable(build_miter(lhs, rhs)).answer
@@ -0,0 +1,58 @@
+import pytest
+
+from cirbo.core.circuit import Circuit, gate
+from cirbo.minimization import MockturtleAlgorithm, MockturtleOptimization
+from cirbo.minimization.exception import UnsupportedOperationError
+from cirbo.synthesis.circuit_search import Basis
+from cirbo.synthesis.generation.arithmetics import generate_mul, generate_sum_n_bits
+
+from tests.cirbo.minimization.equivalence_utils import assert_equivalent
+
+
+def _gate_types(circuit: Circuit) -> set[gate.GateType]:
+    return {circuit.get_gate(label).gate_type for label in circuit.gates}
+
+
+@pytest.mark.parametrize("algorithm", list(MockturtleAlgorithm))
+@pytest.mark.parametrize("basis", [Basis.AIG, Basis.XAIG])
+def test_mockturtle_algorithms(algorithm: MockturtleAlgorithm, basis: Basis):
+    instance = generate_sum_n_bits(5)
+
+    result = MockturtleOptimization([algorithm], basis).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.inputs == instance.inputs
+    assert _gate_types(result) <= {gate.INPUT, gate.AND, gate.XOR, gate.NOT}
+
+
+@pytest.mark.parametrize("basis", [Basis.AIG, Basis.XAIG])
+def test_mockturtle_default_script(basis: Basis):
+    instance = generate_mul(3, 3)
+
+    result = MockturtleOptimization(basis=basis).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert (gate.XOR in _gate_types(result)) == (basis == Basis.XAIG)
+
+
+def test_mockturtle_trivial_outputs():
+    instance = Circuit()
+    instance.add_gate(gate.Gate('A', gate.INPUT))
+    instance.add_gate(gate.Gate('B', gate.INPUT))
+    instance.emplace_gate('NA', gate.NOT, ('A',))
+    instance.emplace_gate('F', gate.GT, ('A', 'A'))
+    instance.emplace_gate('T', gate.ALWAYS_TRUE, ())
+    instance.emplace_gate('X', gate.NAND, ('A', 'NA'))
+    instance.set_outputs(['B', 'NA', 'F', 'T', 'X', 'A'])
+
+    result = MockturtleOptimization().transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.outputs[0] == 'B'
+    assert result.outputs[5] == 'A'
+    assert result.gates_number() == 0
+
+
+def test_mockturtle_unsupported_basis():
+    with pytest.raises(UnsupportedOperationError):
+        MockturtleOptimization(basis=Basis.FULL)
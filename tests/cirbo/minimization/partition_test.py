@@ -0,0 +1,87 @@
+import copy
+
+import pytest
+
+from cirbo.core.circuit import Circuit, gate
+from cirbo.minimization import (
+    cleanup,
+    extract_partition,
+    PartitionedOptimization,
+    partition_circuit,
+)
+from cirbo.minimization.simplification import MergeDuplicateGates
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
+
+from tests.cirbo.minimization.equivalence_utils import assert_equivalent
+
+
+def _redundant_chain(n: int) -> Circuit:
+    # Chain of pairs of duplicate gates, each pair can be merged into a single gate.
+    instance = Circuit()
+    instance.add_gate(gate.Gate('x', gate.INPUT))
+    previous = 'x'
+    for i in range(n):
+        instance.add_gate(gate.Gate(f'i{i}', gate.INPUT))
+        instance.emplace_gate(f'a{i}', gate.AND, (previous, f'i{i}'))
+        instance.emplace_gate(f'b{i}', gate.AND, (previous, f'i{i}'))
+        instance.emplace_gate(f'c{i}', gate.XOR, (f'a{i}', f'b{i}'))
+        instance.emplace_gate(f'd{i}', gate.OR, (f'a{i}', f'c{i}'))
+        previous = f'd{i}'
+    instance.set_outputs([previous, 'x', 'a0'])
+    return instance
+
+
+@pytest.mark.parametrize("max_gates", [1, 3, 7, 100])
+def test_partition_circuit(max_gates: int):
+    instance = generate_sum_n_bits(6)
+    instance.emplace_gate('dangling', gate.AND, tuple(instance.inputs[:2]))
+
+    partitions = partition_circuit(instance, max_gates)
+
+    labels = [label for p in partitions for label in p.gates]
+    assert len(labels) == len(set(labels))
+    assert 'dangling' not in labels
+    assert all(len(p.gates) <= max_gates for p in partitions)
+
+    available = set(instance.inputs)
+    for p in partitions:
+        assert set(p.inputs) <= available
+        available |= set(p.outputs)
+        extract_partition(instance, p)
+    assert set(instance.outputs) <= available
+
+
+@pytest.mark.parametrize("max_workers", [1, 2])
+@pytest.mark.parametrize("optimizer", [cleanup, MergeDuplicateGates()])
+def test_partitioned_optimization(optimizer, max_workers: int):
+    instance = _redundant_chain(6)
+
+    result = PartitionedOptimization(
+        optimizer,
+        max_partition_size=5,
+        max_workers=max_workers,
+        check_equivalence=True,
+    ).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.inputs == instance.inputs
+    assert result.gates_number() < instance.gates_number()
+    assert result.outputs[1] == 'x'
+
+
+def test_partitioned_optimization_keeps_worse_partitions():
+    def _worsen(circuit: Circuit) -> Circuit:
+        circuit = copy.deepcopy(circuit)
+        label = circuit.outputs[0]
+        circuit.emplace_gate('extra', gate.AND, (label, label))
+        circuit.set_outputs(['extra'] + circuit.outputs[1:])
+        return circuit
+
+    instance = generate_sum_n_bits(3)
+
+    result = PartitionedOptimization(
+        _worsen, max_partition_size=3, max_workers=1
+    ).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.gates_number() == instance.gates_number()
@@ -0,0 +1,124 @@
+import copy
+
+import pytest
+
+from cirbo.core.circuit import Circuit, gate
+from cirbo.minimization import (
+    cleanup,
+    MockturtleOptimization,
+    PortfolioCriterion,
+    run_portfolio,
+)
+from cirbo.minimization.simplification import MergeDuplicateGates
+
+from tests.cirbo.minimization.equivalence_utils import assert_equivalent
+
+
+def _instance() -> Circuit:
+    # Chain of ORs with duplicate gate, balanced version has smaller depth.
+    instance = Circuit()
+    for label in 'abcdef':
+        instance.add_gate(gate.Gate(label, gate.INPUT))
+    instance.emplace_gate('g1', gate.OR, ('a', 'b'))
+    instance.emplace_gate('g2', gate.OR, ('g1', 'c'))
+    instance.emplace_gate('g3', gate.OR, ('g2', 'd'))
+    instance.emplace_gate('g4', gate.OR, ('g3', 'e'))
+    instance.emplace_gate('g5', gate.OR, ('g4', 'f'))
+    instance.emplace_gate('h5', gate.OR, ('g4', 'f'))
+    instance.set_outputs(['g5', 'h5'])
+    return instance
+
+
+def _balance(circuit: Circuit) -> Circuit:
+    result = Circuit()
+    for label in 'abcdef':
+        result.add_gate(gate.Gate(label, gate.INPUT))
+    result.emplace_gate('ab', gate.OR, ('a', 'b'))
+    result.emplace_gate('cd', gate.OR, ('c', 'd'))
+    result.emplace_gate('ef', gate.OR, ('e', 'f'))
+    result.emplace_gate('abcd', gate.OR, ('ab', 'cd'))
+    result.emplace_gate('x', gate.OR, ('abcd', 'ef'))
+    result.emplace_gate('y', gate.OR, ('abcd', 'ef'))
+    result.set_outputs(['x', 'y'])
+    return result
+
+
+def _worsen(circuit: Circuit) -> Circuit:
+    result = copy.deepcopy(circuit)
+    result.emplace_gate('extra', gate.AND, ('a', 'b'))
+    return result
+
+
+def _fail(circuit: Circuit) -> Circuit:
+    raise RuntimeError()
+
+
+@pytest.mark.parametrize(
+    "criterion, expected_name, expected_size, expected_depth",
+    [
+        (PortfolioCriterion.SIZE, 'merge', 5, 5),
+        (PortfolioCriterion.DEPTH, 'balance', 6, 3),
+    ],
+)
+def test_portfolio_criterion(
+    criterion: PortfolioCriterion,
+    expected_name: str,
+    expected_size: int,
+    expected_depth: int,
+):
+    instance = _instance()
+
+    result = run_portfolio(
+        instance,
+        {
+            'merge': MergeDuplicateGates(),
+            'balance': _balance,
+            'worsen': _worsen,
+            'fail': _fail,
+        },
+        criterion=criterion,
+        max_workers=2,
+    )
+
+    assert_equivalent(instance, result.circuit)
+    assert result.name == expected_name
+    assert result.size == expected_size == result.circuit.gates_number()
+    assert result.depth == expected_depth
+    assert result.time >= 0
+
+
+def test_portfolio_keeps_original():
+    instance = _instance()
+
+    result = run_portfolio(instance, {'worsen': _worsen, 'fail': _fail})
+
+    assert result.name == 'original'
+    assert result.circuit is instance
+
+
+def test_portfolio_target():
+    instance = _instance()
+
+    result = run_portfolio(
+        instance,
+        {'cleanup': cleanup, 'mockturtle': MockturtleOptimization()},
+        target=6,
+    )
+
+    assert result.name == 'original'
+
+    result = run_portfolio(instance, {'cleanup': cleanup}, target=5)
+
+    assert_equivalent(instance, result.circuit)
+    assert result.name == 'cleanup'
+    assert result.size == 5
+
+
+@pytest.mark.ABC
+def test_portfolio_abc_scripts():
+    instance = _instance()
+
+    result = run_portfolio(instance, {'dc2': 'strash; dc2', 'fraig': 'strash; fraig'})
+
+    assert_equivalent(instance, result.circuit)
+    assert result.size <= instance.gates_number()
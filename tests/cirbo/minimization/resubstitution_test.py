@@ -0,0 +1,128 @@
+import pytest
+
+from cirbo.core.circuit import Circuit, gate
+from cirbo.minimization import Resubstitution
+from cirbo.synthesis.circuit_search import Basis
+
+from tests.cirbo.minimization.equivalence_utils import assert_equivalent
+
+
+@pytest.mark.parametrize("basis", [Basis.AIG, Basis.XAIG])
+def test_resubstitution_existing_gate(basis: Basis):
+    # NOR(NOT(A), NOT(B)) is equal to the existing AND(A, B)
+    instance = Circuit()
+    instance.add_gate(gate.Gate('A', gate.INPUT))
+    instance.add_gate(gate.Gate('B', gate.INPUT))
+    instance.emplace_gate('AB', gate.AND, ('A', 'B'))
+    instance.emplace_gate('NA', gate.NOT, ('A',))
+    instance.emplace_gate('NB', gate.NOT, ('B',))
+    instance.emplace_gate('Y', gate.NOR, ('NA', 'NB'))
+    instance.emplace_gate('Z', gate.OR, ('Y', 'A'))
+    instance.set_outputs(['AB', 'Y', 'Z'])
+
+    result = Resubstitution(basis).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.gates_number() == 1
+    assert result.outputs == ['AB', 'AB', 'A']
+
+
+@pytest.mark.parametrize("basis", [Basis.AIG, Basis.XAIG])
+def test_resubstitution_one_gate(basis: Basis):
+    # AND(AND(A, B), AND(B, C)) is equal to AND(AB, C), so BC becomes redundant
+    instance = Circuit()
+    instance.add_gate(gate.Gate('A', gate.INPUT))
+    instance.add_gate(gate.Gate('B', gate.INPUT))
+    instance.add_gate(gate.Gate('C', gate.INPUT))
+    instance.emplace_gate('AB', gate.AND, ('A', 'B'))
+    instance.emplace_gate('BC', gate.AND, ('B', 'C'))
+    instance.emplace_gate('X', gate.AND, ('AB', 'BC'))
+    instance.set_outputs(['AB', 'X'])
+
+    result = Resubstitution(basis).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.gates_number() == 2
+    assert not result.has_gate('BC')
+    assert result.outputs == ['AB', 'X']
+
+
+def test_resubstitution_two_gates():
+    # AND(AND(A, C), AND(B, D)) is equal to AND(AB, AND(C, D)), which requires
+    # two new gates, but makes three gates redundant
+    instance = Circuit()
+    for label in 'ABCD':
+        instance.add_gate(gate.Gate(label, gate.INPUT))
+    instance.emplace_gate('AB', gate.AND, ('A', 'B'))
+    instance.emplace_gate('AC', gate.AND, ('A', 'C'))
+    instance.emplace_gate('BD', gate.AND, ('B', 'D'))
+    instance.emplace_gate('X', gate.AND, ('AC', 'BD'))
+    instance.set_outputs(['AB', 'X'])
+
+    result = Resubstitution(Basis.AIG).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.gates_number() == 3
+
+    result = Resubstitution(Basis.AIG, max_inserted_gates=1).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.gates_number() == 4
+
+
+@pytest.mark.parametrize("basis", [Basis.AIG, Basis.XAIG])
+def test_resubstitution_basis(basis: Basis):
+    # A XOR B can be computed from A|B and AB with one XOR or GT gate
+    instance = Circuit()
+    instance.add_gate(gate.Gate('A', gate.INPUT))
+    instance.add_gate(gate.Gate('B', gate.INPUT))
+    instance.emplace_gate('AB', gate.AND, ('A', 'B'))
+    instance.emplace_gate('A|B', gate.OR, ('A', 'B'))
+    instance.emplace_gate('GT', gate.GT, ('A', 'B'))
+    instance.emplace_gate('LT', gate.LT, ('A', 'B'))
+    instance.emplace_gate('X', gate.OR, ('GT', 'LT'))
+    instance.set_outputs(['AB', 'A|B', 'X'])
+
+    result = Resubstitution(basis).transform(instance)
+
+    assert_equivalent(instance, result)
+    assert result.gates_number() == 3
+    if basis == Basis.AIG:
+        assert all(
+            result.get_gate(label).gate_type not in (gate.XOR, gate.NXOR)
+            for label in result.gates
+        )
+
+
+def test_resubstitution_random_simulation():
+    # Circuit has too many inputs to be simulated exhaustively, so candidates
+    # found by random simulation are verified by SAT-solver.
+    instance = Circuit()
+    inputs = [f'x{i}' for i in range(12)]
+    for label in inputs:
+        instance.add_gate(gate.Gate(label, gate.INPUT))
+    instance.emplace_gate('P', gate.AND, tuple(inputs[:6]))
+    instance.emplace_gate('Q', gate.AND, tuple(inputs[6:]))
+    instance.emplace_gate('PQ', gate.AND, ('P', 'Q'))
+    instance.emplace_gate('R', gate.AND, ('PQ', 'x0'))
+    instance.emplace_gate('S', gate.OR, ('P', 'x11'))
+    instance.set_outputs(['PQ', 'R', 'S'])
+
+    for simulation_size in (1, 1024):
+        result = Resubstitution(simulation_size=simulation_size).transform(instance)
+
+        assert_equivalent(instance, result)
+        assert result.gates_number() == 4
+        assert result.outputs == ['PQ', 'PQ', 'S']
+
+
+def test_resubstitution_is_idempotent_on_optimal_circuit():
+    instance = Circuit()
+    instance.add_gate(gate.Gate('A', gate.INPUT))
+    instance.add_gate(gate.Gate('B', gate.INPUT))
+    instance.emplace_gate('X', gate.XOR, ('A', 'B'))
+    instance.set_outputs(['X'])
+
+    assert Resubstitution().transform(instance).format_circuit() == (
+        instance.format_circuit()
+    )
@@ -1,6 +1,5 @@
 import collections
-
-import pytest
+import itertools
 
 from cirbo.core.circuit.circuit import Circuit
 from cirbo.core.circuit.gate import (
@@ -19,11 +18,17 @@ from cirbo.core.circuit.gate import (
     OR,
     XOR,
 )
-from cirbo.minimization.exception import UnsupportedOperationError
+from cirbo.core.logic import DontCare
 from cirbo.minimization.subcircuit import (
+    _build_subcircuit,
+    _eval_dont_cares,
+    _estimate_lower_bound,
     _generate_inputs_tt,
     _get_internal_gates,
     _get_subcircuits,
+    _get_windows,
+    _rank_subcircuits,
+    _Subcircuit,
     minimize_subcircuits,
 )
 from cirbo.synthesis.circuit_search import Basis
@@ -119,6 +124,255 @@ def test_get_subcircuits():
     )
 
 
+def test_get_windows():
+    instance = Circuit()
+
+    instance.add_gate(Gate('A', INPUT))
+    instance.add_gate(Gate('B', INPUT))
+    instance.add_gate(Gate('C', INPUT))
+    instance.add_gate(Gate('AB', AND, ('A', 'B')))
+    instance.add_gate(Gate('BC', AND, ('B', 'C')))
+    instance.add_gate(Gate('X', AND, ('AB', 'BC')))
+    instance.add_gate(Gate('Y', OR, ('BC', 'C')))
+    instance.mark_as_output('X')
+    instance.mark_as_output('Y')
+
+    windows = [
+        (['A', 'B', 'C'], ['AB', 'BC', 'X']),
+        (['B', 'C'], ['BC', 'Y']),
+    ]
+    subcircuits = _get_windows(instance, windows)
+
+    assert len(subcircuits) == 2
+    assert sorted(subcircuits[0].inputs) == ['A', 'B', 'C']
+    assert subcircuits[0].gates.index('X') > subcircuits[0].gates.index('AB')
+    assert sorted(subcircuits[0].outputs) == ['BC', 'X']
+    assert subcircuits[0].size == 3
+    assert subcircuits[0].patterns['X'] == 128
+    assert sorted(subcircuits[1].outputs) == ['BC', 'Y']
+    assert subcircuits[1].size == 2
+
+
+def test_minimize_subcircuits_windows():
+    # AND of three inputs is computed with reconvergence which is not seen by cuts
+    # of size two, but is covered by a window
+    instance = Circuit()
+
+    instance.add_gate(Gate('A', INPUT))
+    instance.add_gate(Gate('B', INPUT))
+    instance.add_gate(Gate('C', INPUT))
+    instance.add_gate(Gate('AB', AND, ('A', 'B')))
+    instance.add_gate(Gate('BC', AND, ('B', 'C')))
+    instance.add_gate(Gate('X', AND, ('AB', 'BC')))
+    instance.mark_as_output('X')
+
+    minimized_circuit = minimize_subcircuits(
+        instance, basis=Basis.AIG, enable_validation=True, cut_size=2
+    )
+    assert minimized_circuit.size == 6
+    minimized_circuit = minimize_subcircuits(
+        instance,
+        basis=Basis.AIG,
+        enable_validation=True,
+        cut_size=2,
+        window_inputs=4,
+    )
+    assert minimized_circuit.size == 5
+
+
+def test_eval_dont_cares():
+    # X is observable only if B is true, B is false whenever L is false
+    instance = Circuit()
+
+    instance.add_gate(Gate('A', INPUT))
+    instance.add_gate(Gate('B', INPUT))
+    instance.add_gate(Gate('C', INPUT))
+    instance.add_gate(Gate('L', OR, ('A', 'B')))
+    instance.add_gate(Gate('X', AND, ('L', 'C')))
+    instance.add_gate(Gate('G', AND, ('X', 'B')))
+    instance.mark_as_output('G')
+
+    subcircuit = _build_subcircuit(
+        instance, ['L', 'C'], ['C', 'L', 'X'], {'G'}, _generate_inputs_tt(2)
+    )
+    assert subcircuit.inputs == ['C', 'L']
+
+    _eval_dont_cares(instance, [subcircuit])
+    assert subcircuit.inputs_tt == ['00', '01', '10', '11']
+    assert subcircuit.evaluate_truth_table_with_dont_cares() == [
+        [False, False, False, True]
+    ]
+
+    _eval_dont_cares(instance, [subcircuit], odc_levels=1)
+    assert subcircuit.odc == {'X': 0b0101}
+    assert subcircuit.evaluate_truth_table_with_dont_cares() == [
+        [DontCare, False, DontCare, True]
+    ]
+
+    # G is an output of the circuit, so it is always observable
+    subcircuit = _build_subcircuit(
+        instance, ['X', 'B'], ['B', 'X', 'G'], {'G'}, _generate_inputs_tt(2)
+    )
+    _eval_dont_cares(instance, [subcircuit], odc_levels=1)
+    assert subcircuit.odc == {'G': 0}
+
+
+def test_eval_dont_cares_opposite_outputs():
+    # X is observable only if B is true, but Y = NOT X is an output of the circuit.
+    # Y is computed as negation of X by the new subcircuit, so X is always observable.
+    instance = Circuit()
+
+    instance.add_gate(Gate('A', INPUT))
+    instance.add_gate(Gate('B', INPUT))
+    instance.add_gate(Gate('C', INPUT))
+    instance.add_gate(Gate('D', INPUT))
+    instance.add_gate(Gate('L', OR, ('A', 'B')))
+    instance.add_gate(Gate('T', AND, ('L', 'C')))
+    instance.add_gate(Gate('X', AND, ('T', 'D')))
+    instance.add_gate(Gate('Y', NAND, ('T', 'D')))
+    instance.add_gate(Gate('G', AND, ('X', 'B')))
+    instance.mark_as_output('G')
+    instance.mark_as_output('Y')
+
+    subcircuit = _build_subcircuit(
+        instance,
+        ['L', 'C', 'D'],
+        ['C', 'D', 'L', 'T', 'X', 'Y'],
+        {'G', 'Y'},
+        _generate_inputs_tt(3),
+    )
+    assert subcircuit.outputs == ['X', 'Y']
+    _eval_dont_cares(instance, [subcircuit], odc_levels=1)
+    assert subcircuit.odc == {'X': 0, 'Y': 0}
+
+    for odc_levels in (1, 3):
+        minimized_circuit = minimize_subcircuits(
+            instance,
+            basis=Basis.AIG,
+            enable_validation=True,
+            cut_size=3,
+            odc_levels=odc_levels,
+        )
+        assert minimized_circuit.size <= instance.size
+
+
+def test_minimize_subcircuits_odc():
+    # X = AND(T, D) is not observable if L is false, so it equals AND(C, D)
+    instance = Circuit()
+
+    instance.add_gate(Gate('A', INPUT))
+    instance.add_gate(Gate('B', INPUT))
+    instance.add_gate(Gate('C', INPUT))
+    instance.add_gate(Gate('D', INPUT))
+    instance.add_gate(Gate('L', OR, ('A', 'B')))
+    instance.add_gate(Gate('T', AND, ('L', 'C')))
+    instance.add_gate(Gate('X', AND, ('T', 'D')))
+    instance.add_gate(Gate('G', AND, ('X', 'B')))
+    instance.mark_as_output('G')
+
+    minimized_circuit = minimize_subcircuits(
+        instance, basis=Basis.AIG, enable_validation=True, cut_size=3
+    )
+    assert minimized_circuit.size == 8
+    for odc_levels in (1, 3):
+        minimized_circuit = minimize_subcircuits(
+            instance,
+            basis=Basis.AIG,
+            enable_validation=True,
+            cut_size=3,
+            odc_levels=odc_levels,
+        )
+        assert minimized_circuit.size == 7
+
+
+def test_minimize_subcircuits_odc_adjacent():
+    # Two adjacent subcircuits are simplified using observability don't cares:
+    # X = AND(T, D) equals AND(C, D) if B is true and Y = AND(U, K) equals AND(G, K)
+    # if F is true, so don't cares of the second one are reevaluated after the first
+    # replacement.
+    instance = Circuit()
+
+    for label in ('A', 'B', 'C', 'D', 'E', 'F', 'K'):
+        instance.add_gate(Gate(label, INPUT))
+    instance.add_gate(Gate('L', OR, ('A', 'B')))
+    instance.add_gate(Gate('T', AND, ('L', 'C')))
+    instance.add_gate(Gate('X', AND, ('T', 'D')))
+    instance.add_gate(Gate('G', AND, ('X', 'B')))
+    instance.add_gate(Gate('M', OR, ('E', 'F')))
+    instance.add_gate(Gate('U', AND, ('M', 'G')))
+    instance.add_gate(Gate('Y', AND, ('U', 'K')))
+    instance.add_gate(Gate('H', AND, ('Y', 'F')))
+    instance.mark_as_output('H')
+
+    minimized_circuit = minimize_subcircuits(
+        instance, basis=Basis.AIG, enable_validation=True, cut_size=3
+    )
+    assert minimized_circuit.size == 15
+    for odc_levels in (1, 3):
+        minimized_circuit = minimize_subcircuits(
+            instance,
+            basis=Basis.AIG,
+            enable_validation=True,
+            cut_size=3,
+            odc_levels=odc_levels,
+        )
+        assert minimized_circuit.size == 13
+
+
+def test_estimate_lower_bound():
+    subcircuit = _Subcircuit(inputs=['A', 'B', 'C'], outputs=['X', 'Y'], size=4)
+
+    # AND of three inputs requires two binary gates.
+    assert _estimate_lower_bound(subcircuit, [[t == 7 for t in range(8)]]) == 2
+    # Literals and constants require no gates.
+    assert _estimate_lower_bound(subcircuit, [[not t & 2 for t in range(8)]]) == 0
+    assert _estimate_lower_bound(subcircuit, [[True] * 8]) == 0
+    # Two different non-trivial outputs require at least two gates.
+    assert (
+        _estimate_lower_bound(
+            subcircuit,
+            [[t & 3 == 3 for t in range(8)], [t & 6 == 6 for t in range(8)]],
+        )
+        == 2
+    )
+    # Output and its negation may share a gate.
+    assert (
+        _estimate_lower_bound(
+            subcircuit,
+            [[t & 3 == 3 for t in range(8)], [t & 3 != 3 for t in range(8)]],
+        )
+        == 1
+    )
+    # Don't cares make output compatible with an input.
+    assert (
+        _estimate_lower_bound(
+            subcircuit,
+            [[False, DontCare, False, DontCare, False, True, DontCare, True]],
+        )
+        == 0
+    )
+
+
+def test_rank_subcircuits():
+    def _make_subcircuit(inputs, output_pattern, size):
+        return _Subcircuit(
+            inputs=inputs,
+            outputs=['X'],
+            size=size,
+            inputs_tt=[''.join(x) for x in itertools.product('01', repeat=len(inputs))],
+            patterns=collections.defaultdict(int, {'X': output_pattern}),
+        )
+
+    trivial = _make_subcircuit(['A', 'B'], 10, 2)  # X = A
+    optimal = _make_subcircuit(['A', 'B'], 8, 1)  # X = AND(A, B)
+    and3 = _make_subcircuit(['A', 'B', 'C'], 128, 3)  # X = AND(A, B, C)
+    xor3 = _make_subcircuit(['A', 'B', 'C'], 150, 4)  # X = XOR(A, B, C)
+
+    ranked = _rank_subcircuits([and3, optimal, xor3, trivial])
+    assert ranked == [trivial, xor3, and3]
+    assert [x.gain for x in ranked] == [2, 2, 1]
+
+
 def test_get_internal_gates():
 
     instance = Circuit()
@@ -366,8 +620,9 @@ def test_minimize_subcircuits7():
     assert minimized_circuit.size == 26
 
 
-def test_exception():
-    # Test exception for unsupported operations
+def test_minimize_subcircuits_degenerate_gates():
+    # Gates which depend on one operand only, e.g. ones emitted by CircuitFinderSat,
+    # are simulated as any other gate.
     instance = Circuit()
 
     instance.add_gate(Gate('A', INPUT))
@@ -378,10 +633,15 @@ def test_exception():
     instance.add_gate(Gate('F', LIFF, ('D', 'E')))
     instance.mark_as_output('F')
 
-    with pytest.raises(UnsupportedOperationError):
-        minimized_circuit = minimize_subcircuits(
-            instance, basis=Basis.XAIG, enable_validation=True
-        )
+    subcircuit = _build_subcircuit(
+        instance, ['D', 'E'], ['D', 'E', 'F'], {'F'}, _generate_inputs_tt(2)
+    )
+    assert subcircuit.patterns['F'] == subcircuit.patterns['D']
+
+    minimized_circuit = minimize_subcircuits(
+        instance, basis=Basis.XAIG, enable_validation=True
+    )
+    assert minimized_circuit.size <= instance.size
 
     instance.remove_gate('F')
     instance.add_gate(Gate('F', LEQ, ('D', 'E')))
@@ -0,0 +1,38 @@
+import itertools
+
+import pytest
+from pysat.formula import IDPool
+from pysat.solvers import Solver
+
+from cirbo.sat.cnf import at_most_one, AtMostOneEncoding, exactly_one
+
+
+@pytest.mark.parametrize('encoding', list(AtMostOneEncoding))
+@pytest.mark.parametrize('n', [1, 2, 5, 10, 17])
+@pytest.mark.parametrize('exact', [False, True])
+def test_cardinality_encoding(encoding: AtMostOneEncoding, n: int, exact: bool):
+    vpool = IDPool()
+    literals = [vpool.id(f'x_{i}') for i in range(n)]
+    # Encoding must work with negative literals too.
+    literals[0] = -literals[0]
+    encode = exactly_one if exact else at_most_one
+    clauses = encode(literals, vpool.id, encoding)
+
+    solver = Solver(name='g3', bootstrap_with=clauses)
+    try:
+        for values in itertools.product([False, True], repeat=min(n, 10)):
+            values += (False,) * (n - len(values))
+            assumptions = [lit if v else -lit for lit, v in zip(literals, values)]
+            expected = sum(values) == 1 if exact else sum(values) <= 1
+            assert solver.solve(assumptions=assumptions) == expected
+    finally:
+        solver.delete()
+
+
+def test_compact_encodings_are_smaller():
+    vpool = IDPool()
+    literals = [vpool.id() for _ in range(36)]
+    pairwise = at_most_one(literals, vpool.id, AtMostOneEncoding.PAIRWISE)
+    for encoding in AtMostOneEncoding:
+        if encoding != AtMostOneEncoding.PAIRWISE:
+            assert len(at_most_one(literals, vpool.id, encoding)) < len(pairwise) // 4
@@ -0,0 +1,30 @@
+import io
+
+import pytest
+
+from cirbo.sat.cnf import Cnf
+
+
+def test_flat_storage():
+    clauses = [[-1, -2], [-1, 3], [], [1, 2, -4]]
+    cnf = Cnf(clauses[:2])
+    cnf.add_clause(clauses[2])
+    cnf.extend(iter(clauses[3:]))
+
+    assert len(cnf) == 4
+    assert list(cnf) == clauses
+    assert cnf.get_raw() == clauses
+    assert cnf[1] == [-1, 3]
+    assert cnf[-1] == [1, 2, -4]
+    with pytest.raises(IndexError):
+        _ = cnf[4]
+    assert cnf.number_of_variables == 4
+    assert cnf.literals.tolist() == [-1, -2, -1, 3, 1, 2, -4]
+    assert cnf.offsets.tolist() == [0, 2, 4, 4, 7]
+
+
+def test_write_dimacs():
+    cnf = Cnf([[1, -2], [], [3]])
+    file = io.StringIO()
+    cnf.write_dimacs(file)
+    assert file.getvalue() == 'p cnf 3 3\n1 -2 0\n0\n3 0\n'
@@ -1,6 +1,29 @@
+import random
 import typing as tp
 
-from cirbo.core.circuit import AND, Circuit, Gate, INPUT, NOT, OR, XOR
+from cirbo.core.circuit import (
+    ALWAYS_FALSE,
+    ALWAYS_TRUE,
+    AND,
+    Circuit,
+    Gate,
+    GEQ,
+    GT,
+    IFF,
+    INPUT,
+    LEQ,
+    LIFF,
+    LNOT,
+    LT,
+    NAND,
+    NOR,
+    NOT,
+    NXOR,
+    OR,
+    RIFF,
+    RNOT,
+    XOR,
+)
 
 from cirbo.sat.cnf import CnfRaw
 
@@ -10,6 +33,7 @@ __all__ = [
     'generate_circuit2',
     'generate_circuit3',
     'generate_circuit4',
+    'generate_random_circuit',
 ]
 
 
@@ -185,3 +209,35 @@ def generate_circuit4() -> tuple[Circuit, CnfRaw]:
         [5],
         [7],
     ]
+
+
+_UNARY = [NOT, IFF]
+_BINARY = [LNOT, RNOT, LIFF, RIFF, AND, NAND, OR, NOR, XOR, NXOR, GT, LT, GEQ, LEQ]
+_CONSTANT = [ALWAYS_TRUE, ALWAYS_FALSE]
+
+
+def generate_random_circuit(inputs: int, gates: int, outputs: int) -> Circuit:
+    """Generates circuit of random gates of all types, using the global `random`."""
+    circuit = Circuit()
+    labels = [f'x{i}' for i in range(inputs)]
+    for label in labels:
+        circuit.add_gate(Gate(label, INPUT))
+    for i in range(gates):
+        label = f'g{i}'
+        choice = random.random()
+        if choice < 0.05:
+            circuit.add_gate(Gate(label, random.choice(_CONSTANT), ()))
+        elif choice < 0.25:
+            operand = random.choice(labels)
+            circuit.add_gate(Gate(label, random.choice(_UNARY), (operand,)))
+        else:
+            circuit.add_gate(
+                Gate(
+                    label,
+                    random.choice(_BINARY),
+                    tuple(random.sample(labels, 2)),
+                )
+            )
+        labels.append(label)
+    circuit.set_outputs(labels[-outputs:])
+    return circuit
@@ -0,0 +1,67 @@
+import itertools
+import random
+
+import pytest
+from pysat.solvers import Solver
+
+from cirbo.core.circuit import ALWAYS_TRUE, AND, Circuit, Gate, INPUT, NOT
+from cirbo.sat.cnf import Cnf, plaisted_greenbaum_transformation
+
+from tests.cirbo.sat.cnf.generator_utils import (
+    generate_circuit1,
+    generate_circuit2,
+    generate_circuit3,
+    generate_circuit4,
+    generate_random_circuit,
+)
+
+
+def _check_equisatisfiable(circuit: Circuit, cnf: Cnf):
+    """Checks that CNF restricted to input values is true iff all outputs are true."""
+    with Solver(name='g3', bootstrap_with=cnf) as solver:
+        for values in itertools.product([False, True], repeat=len(circuit.inputs)):
+            expected = all(circuit.evaluate(list(values)))
+            assumptions = [i + 1 if v else -(i + 1) for i, v in enumerate(values)]
+            assert solver.solve(assumptions=assumptions) == expected
+
+
+@pytest.mark.parametrize(
+    'generate_circuit',
+    [generate_circuit1, generate_circuit2, generate_circuit3, generate_circuit4],
+)
+def test_plaisted_greenbaum(generate_circuit):
+    circuit, tseytin_cnf = generate_circuit()
+    cnf = plaisted_greenbaum_transformation(circuit)
+    _check_equisatisfiable(circuit, cnf)
+    assert len(cnf) <= len(tseytin_cnf)
+
+
+def test_plaisted_greenbaum_random_circuits():
+    random.seed(17)
+    for _ in range(200):
+        circuit = generate_random_circuit(
+            inputs=random.randint(2, 5),
+            gates=random.randint(1, 20),
+            outputs=random.randint(1, 3),
+        )
+        _check_equisatisfiable(circuit, plaisted_greenbaum_transformation(circuit))
+
+
+def test_plaisted_greenbaum_simplifications():
+    circuit = Circuit()
+    for label in 'abcd':
+        circuit.add_gate(Gate(label, INPUT))
+    circuit.add_gate(Gate('not_a', NOT, ('a',)))
+    circuit.add_gate(Gate('not_not_a', NOT, ('not_a',)))
+    circuit.add_gate(Gate('one', ALWAYS_TRUE, ()))
+    circuit.add_gate(Gate('and1', AND, ('not_not_a', 'b')))
+    circuit.add_gate(Gate('and2', AND, ('c', 'one')))
+    circuit.add_gate(Gate('and3', AND, ('and1', 'and2')))
+    circuit.add_gate(Gate('and4', AND, ('and3', 'd')))
+    circuit.set_outputs(['and4'])
+
+    # AND tree is merged into a single gate used only positively.
+    cnf = plaisted_greenbaum_transformation(circuit)
+    assert sorted(map(sorted, cnf)) == [[-5, 1], [-5, 2], [-5, 3], [-5, 4], [5]]
+    tseytin = Cnf.from_circuit(circuit)
+    assert len(cnf) < len(tseytin)
@@ -2,8 +2,15 @@ import typing as tp
 
 import pytest
 
-from cirbo.core.circuit import Circuit
-from cirbo.sat.cnf import Cnf, CnfRaw
+from cirbo.core.circuit import AND, Circuit, HierarchicalCircuit
+from cirbo.sat.cnf import (
+    Cnf,
+    CnfRaw,
+    hierarchical_tseytin_transformation,
+    tseytin_transformation,
+)
+from cirbo.sat.counting import count_models
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
 
 from tests.cirbo.sat.cnf.generator_utils import (
     generate_circuit1,
@@ -26,3 +33,21 @@ def test_tseytin(generate_circuit: tp.Callable[[], tp.Tuple[Circuit, CnfRaw]]):
     circuit, expected_cnf = generate_circuit()
     cnf = Cnf.from_circuit(circuit).get_raw()
     assert cnf == expected_cnf
+
+
+@pytest.mark.parametrize('outputs', [None, [0], [1], [2]])
+def test_hierarchical_tseytin(outputs: tp.Optional[list[int]]):
+    adder = generate_sum_n_bits(3)
+    circuit = HierarchicalCircuit()
+    circuit.add_inputs([f'x{i}' for i in range(5)])
+    first = circuit.add_instance('a', adder, ['x0', 'x1', 'x2'])
+    second = circuit.add_instance('b', adder, [first[0], 'x3', 'x4'])
+    circuit.emplace_gate('g', AND, (first[1], second[0]))
+    circuit.set_outputs(['g', second[1], 'x0'])
+
+    cnf = hierarchical_tseytin_transformation(circuit, outputs)
+    flat_cnf = tseytin_transformation(circuit.flatten(), outputs)
+    # Both encodings are functional, so models correspond to input assignments.
+    assert count_models(cnf.get_raw(), cnf.number_of_variables) == count_models(
+        flat_cnf.get_raw(), flat_cnf.number_of_variables
+    )
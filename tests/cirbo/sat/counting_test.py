@@ -0,0 +1,139 @@
+import itertools
+import math
+import random
+
+import pytest
+from cirbo.core.circuit import AND, Circuit, compiled, Gate, INPUT, NOT, OR, XOR
+from cirbo.sat import build_miter, count_models, count_satisfying_assignments, counting
+from cirbo.sat.cnf import Cnf
+from cirbo.synthesis.generation import GenerationBasis
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
+
+from tests.cirbo.sat.cnf.generator_utils import generate_random_circuit
+
+
+def _count_by_truth_table(circuit: Circuit, outputs: list[int]) -> int:
+    return sum(
+        all(values[i] for i in outputs) for values in zip(*circuit.get_truth_table())
+    )
+
+
+@pytest.mark.parametrize('seed', range(20))
+@pytest.mark.parametrize('simulation_limit', [0, 32])
+def test_count_random_circuits(seed: int, simulation_limit: int):
+    random.seed(seed)
+    circuit = generate_random_circuit(inputs=6, gates=25, outputs=3)
+    for outputs in [[0], [1, 2], [0, 1, 2]]:
+        assert count_satisfying_assignments(
+            circuit,
+            outputs,
+            simulation_limit=simulation_limit,
+            split_inputs=2,
+        ) == _count_by_truth_table(circuit, outputs)
+
+
+def test_count_unused_inputs():
+    circuit = Circuit()
+    for label in ['x0', 'x1', 'x2']:
+        circuit.add_gate(Gate(label, INPUT))
+    circuit.add_gate(Gate('not', NOT, ('x1',)))
+    circuit.set_outputs(['not', 'x2'])
+    assert count_satisfying_assignments(circuit) == 2
+    assert count_satisfying_assignments(circuit, simulation_limit=0) == 2
+    assert count_satisfying_assignments(circuit, [1]) == 4
+
+
+@pytest.fixture(params=['native', 'python'])
+def backend(request, monkeypatch):
+    if request.param == 'python':
+        monkeypatch.setattr(counting, 'compile_native_program', lambda *args: None)
+    elif compiled._NativeProgram is None:
+        pytest.skip('package is built without extensions')
+    return request.param
+
+
+@pytest.mark.parametrize('inputs', [17, 20])
+def test_count_by_simulation_with_blocks(inputs: int, backend: str):
+    # Parity of many inputs spans several blocks of the simulation.
+    circuit = Circuit()
+    for i in range(inputs):
+        circuit.add_gate(Gate(f'x{i}', INPUT))
+    circuit.add_gate(Gate('parity', XOR, tuple(f'x{i}' for i in range(inputs))))
+    circuit.add_gate(Gate('and', AND, ('x0', 'x1')))
+    circuit.set_outputs(['parity', 'and'])
+    assert count_satisfying_assignments(circuit, [0]) == 2 ** (inputs - 1)
+    assert count_satisfying_assignments(circuit) == 2 ** (inputs - 3)
+    assert count_satisfying_assignments(circuit, [1], workers=2) == 2 ** (inputs - 2)
+
+
+@pytest.mark.parametrize('output', [0, 1])
+def test_count_wide_circuit(output: int):
+    # 33 inputs are beyond the simulation limit: output `i` is `i`-th bit of number of
+    # ones among inputs.
+    n = 33
+    circuit = generate_sum_n_bits(n)
+    expected = sum(math.comb(n, k) for k in range(n + 1) if (k >> output) & 1)
+    assert count_satisfying_assignments(circuit, [output]) == expected
+
+
+@pytest.mark.parametrize('simulation_limit', [0, 32])
+def test_count_miter(simulation_limit: int):
+    # Second circuit has two lowest bits of the sum swapped, so they differ whenever
+    # number of ones is 1 or 2 modulo 4.
+    n = 8
+    left = generate_sum_n_bits(n)
+    right = generate_sum_n_bits(n, basis=GenerationBasis.AIG)
+    outputs = list(right.outputs)
+    outputs[0], outputs[1] = outputs[1], outputs[0]
+    right.set_outputs(outputs)
+    expected = sum(math.comb(n, k) for k in range(n + 1) if k % 4 in (1, 2))
+    miter = build_miter(left, right)
+    assert (
+        count_satisfying_assignments(miter, simulation_limit=simulation_limit)
+        == expected
+    )
+
+
+def test_count_models():
+    assert count_models([]) == 1
+    assert count_models([[1, 2]]) == 3
+    assert count_models([[1, 2]], 4) == 12
+    assert count_models([[1], [-1]]) == 0
+    # At most one of four variables, plus an independent clause.
+    clauses = [[-a, -b] for a, b in itertools.combinations(range(1, 5), 2)]
+    assert count_models(clauses + [[5, 6]]) == 5 * 3
+    with pytest.raises(ValueError):
+        count_models([[3]], 2)
+
+
+def test_count_models_empty_clause():
+    assert count_models([[]]) == 0
+    assert count_models([[1, 2], []], 3) == 0
+    # Polarity-aware encoding of a constant false output is an empty clause.
+    circuit = Circuit()
+    circuit.add_gate(Gate('x0', INPUT))
+    circuit.add_gate(Gate('not', NOT, ('x0',)))
+    circuit.add_gate(Gate('and', AND, ('x0', 'not')))
+    circuit.set_outputs(['and'])
+    cnf = Cnf.from_circuit(circuit, polarity_aware=True)
+    assert count_models(cnf, circuit.input_size) == 0
+
+
+def test_count_models_deep_branching():
+    # No three consecutive false variables: a single component, in which every
+    # variable is branched on, deeper than the recursion limit of Python.
+    n = 700
+    clauses = [[i, i + 1, i + 2] for i in range(1, n - 1)]
+    expected = [1, 2, 4]
+    while len(expected) <= n:
+        expected.append(expected[-1] + expected[-2] + expected[-3])
+    assert count_models(clauses, priority=range(1, n + 1)) == expected[n]
+
+
+def test_count_models_of_or():
+    circuit = Circuit()
+    for label in ['x0', 'x1']:
+        circuit.add_gate(Gate(label, INPUT))
+    circuit.add_gate(Gate('or', OR, ('x0', 'x1')))
+    circuit.set_outputs(['or'])
+    assert count_satisfying_assignments(circuit, simulation_limit=0) == 3
@@ -0,0 +1,83 @@
+import random
+
+import pytest
+from cirbo.core.circuit import AND, Circuit, Gate, INPUT, NAND, OR, XOR
+from cirbo.sat import is_circuit_satisfiable, is_satisfiable, preprocess
+from cirbo.sat.cnf import Cnf
+
+
+def _satisfies(clauses, model) -> bool:
+    values = set(model)
+    return all(any(literal in values for literal in clause) for clause in clauses)
+
+
+def _random_cnf(seed: int, variables: int, clauses: int) -> Cnf:
+    rng = random.Random(seed)
+    cnf = Cnf()
+    for _ in range(clauses):
+        chosen = rng.sample(range(1, variables + 1), rng.randint(1, 3))
+        cnf.add_clause(v if rng.random() < 0.5 else -v for v in chosen)
+    return cnf
+
+
+def test_preprocess_restores_model():
+    clauses = [[1], [-1, 2], [-2, 3, 4], [-3, -4], [4, 5]]
+    with preprocess(clauses) as formula:
+        assert formula.stats.clauses_before == 5
+        assert formula.stats.variables_before == 5
+        assert formula.stats.clauses_after < formula.stats.clauses_before
+        assert not formula.is_unsatisfiable
+        result = is_satisfiable(Cnf(formula.clauses))
+        assert result.answer
+        model = formula.restore(result.model)
+    assert _satisfies(clauses, model)
+
+
+def test_preprocess_unsatisfiable():
+    with preprocess([[1, 2], [-1], [-2]]) as formula:
+        assert formula.is_unsatisfiable
+
+
+def test_preprocess_proves_unsatisfiability_without_units():
+    # No clause is unit, so it's refuted only by elimination or probing of variables.
+    clauses = [[1, 2], [1, -2], [-1, 2], [-1, -2]]
+    with preprocess(clauses) as formula:
+        assert formula.is_unsatisfiable
+        assert [] in formula.clauses
+    result = is_satisfiable(Cnf(clauses), preprocess=True)
+    assert not result.answer
+    assert result.preprocessing is not None
+
+
+@pytest.mark.parametrize('seed', range(20))
+def test_is_satisfiable_with_preprocessing(seed: int):
+    cnf = _random_cnf(seed, variables=12, clauses=40)
+    expected = is_satisfiable(cnf)
+    result = is_satisfiable(cnf, preprocess=True)
+    assert result.answer == expected.answer
+    assert result.preprocessing is not None
+    assert result.preprocessing.clauses_before == len(cnf)
+    if result.answer:
+        assert _satisfies(cnf, result.model)
+
+
+def test_is_circuit_satisfiable_with_preprocessing():
+    # x0 XOR x1 is equal to (x0 OR x1) AND NOT (x0 AND x1), so the miter is constant.
+    circuit = Circuit()
+    circuit.add_gate(Gate('x0', INPUT))
+    circuit.add_gate(Gate('x1', INPUT))
+    circuit.add_gate(Gate('xor', XOR, ('x0', 'x1')))
+    circuit.add_gate(Gate('or', OR, ('x0', 'x1')))
+    circuit.add_gate(Gate('nand', NAND, ('x0', 'x1')))
+    circuit.add_gate(Gate('and', AND, ('or', 'nand')))
+    circuit.add_gate(Gate('miter', XOR, ('xor', 'and')))
+    circuit.set_outputs(['miter'])
+    result = is_circuit_satisfiable(circuit, preprocess=True)
+    assert not result.answer
+    assert result.preprocessing is not None
+
+    circuit.set_outputs(['xor'])
+    result = is_circuit_satisfiable(circuit, preprocess=True)
+    assert result.answer
+    assert result.model is not None
+    assert (result.model[0] > 0) != (result.model[1] > 0)
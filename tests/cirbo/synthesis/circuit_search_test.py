@@ -1,4 +1,6 @@
+import concurrent.futures
 import itertools
+import time
 import typing as tp
 
 import pytest
@@ -7,10 +9,16 @@ from cirbo.core.boolean_function import RawTruthTable, RawTruthTableModel
 from cirbo.core.circuit import Circuit
 from cirbo.core.logic import DontCare, TriValue
 from cirbo.core.truth_table import _parse_trival, TruthTableModel
+from cirbo.sat import PySATSolverNames
+from cirbo.sat.cnf import AtMostOneEncoding
 from cirbo.synthesis.circuit_search import (
+    _circuit_depth,
+    _solve_limited,
     _tt_to_gate_type,
     Basis,
     CircuitFinderSat,
+    find_min_size_circuit,
+    find_size_depth_pareto_front,
     Operation,
 )
 from cirbo.synthesis.exception import (
@@ -186,6 +194,38 @@ def test_time_limit(inputs: int, outputs: int, size: int, tl: int):
         )
 
 
+def test_conflict_budget():
+    tt = [
+        ''.join(str((sum(x) >> i) & 1) for x in itertools.product(range(2), repeat=5))
+        for i in range(3)
+    ]
+    with pytest.raises(SolverTimeOutError):
+        CircuitFinderSat(TruthTableModel(tt), 11, basis=Basis.XAIG).find_circuit(
+            conflict_budget=10
+        )
+
+
+def test_time_limit_in_threads():
+    tt = [
+        ''.join(str((sum(x) >> i) & 1) for x in itertools.product(range(2), repeat=5))
+        for i in range(3)
+    ]
+
+    def _find(_: int) -> bool:
+        try:
+            CircuitFinderSat(TruthTableModel(tt), 11, basis=Basis.XAIG).find_circuit(
+                time_limit=1
+            )
+        except SolverTimeOutError:
+            return True
+        return False
+
+    start = time.monotonic()
+    with concurrent.futures.ThreadPoolExecutor(max_workers=4) as executor:
+        assert all(executor.map(_find, range(4)))
+    assert time.monotonic() - start < 30
+
+
 def test_simple_dont_care():
     tt = ["011*"]
     check_exact_circuit_size(1, tt, [Operation.or_], hasdontcares=True)
@@ -205,6 +245,80 @@ def test_get_cnf(tt, size, sat):
     solver.delete()
 
 
+def test_default_at_most_one_encoding_is_pairwise():
+    tt = ["0110", "0001"]
+    default = CircuitFinderSat(TruthTableModel(tt), 3, basis=Basis.XAIG)
+    pairwise = CircuitFinderSat(
+        TruthTableModel(tt), 3, basis=Basis.XAIG, at_most_one_encoding='PAIRWISE'
+    )
+    assert default.get_cnf() == pairwise.get_cnf()
+
+
+@pytest.mark.parametrize("encoding", list(AtMostOneEncoding))
+def test_at_most_one_encodings(encoding: AtMostOneEncoding):
+    tt = ["01101001", "00010111"]
+    circuit = CircuitFinderSat(
+        TruthTableModel(tt), 5, basis=Basis.XAIG, at_most_one_encoding=encoding
+    ).find_circuit()
+    check_correctness(circuit, tt)
+    with pytest.raises(NoSolutionError):
+        CircuitFinderSat(
+            TruthTableModel(tt), 4, basis=Basis.XAIG, at_most_one_encoding=encoding
+        ).find_circuit()
+
+
+@pytest.mark.parametrize("inputs, outputs, size", [(2, 2, 2), (3, 2, 5)])
+def test_cegis_sum_circuits(inputs: int, outputs: int, size: int):
+    tt = [
+        ''.join(
+            str((sum(x) >> i) & 1) for x in itertools.product(range(2), repeat=inputs)
+        )
+        for i in range(outputs)
+    ]
+    circuit = CircuitFinderSat(
+        TruthTableModel(tt), size, basis=Basis.XAIG
+    ).find_circuit(cegis=True)
+    check_correctness(circuit, tt)
+    with pytest.raises(NoSolutionError):
+        CircuitFinderSat(TruthTableModel(tt), size - 1, basis=Basis.XAIG).find_circuit(
+            cegis=True
+        )
+
+
+@pytest.mark.parametrize("inputs", [6, 7])
+def test_cegis_many_inputs(inputs: int):
+    # x_0 x_1 XOR x_2 x_3 XOR ... is computed by at most inputs - 1 gates.
+    tt = [
+        ''.join(
+            str(sum(x[i] & x[i + 1] for i in range(0, inputs - 1, 2)) % 2)
+            for x in itertools.product(range(2), repeat=inputs)
+        )
+    ]
+    finder = CircuitFinderSat(TruthTableModel(tt), inputs - 1, basis=Basis.XAIG)
+    circuit = finder.find_circuit(cegis=True, time_limit=60)
+    check_correctness(circuit, tt)
+    assert len(finder._encoded_rows) < 1 << inputs
+
+
+def test_cegis_dont_care():
+    tt = ["0**1****", "*1**0***"]
+    circuit = CircuitFinderSat(TruthTableModel(tt), 2, basis=Basis.AIG).find_circuit(
+        cegis=True
+    )
+    check_correctness(circuit, tt, hasdontcares=True)
+
+
+def test_cegis_time_limit():
+    tt = [
+        ''.join(str((sum(x) >> i) & 1) for x in itertools.product(range(2), repeat=5))
+        for i in range(3)
+    ]
+    with pytest.raises(SolverTimeOutError):
+        CircuitFinderSat(TruthTableModel(tt), 11, basis=Basis.XAIG).find_circuit(
+            cegis=True, time_limit=1
+        )
+
+
 def test_need_normalized():
     tt = ['00010001', '11110101', '11111010']
     tt_normalized = ['00010001', '00001010', '00000101']
@@ -269,3 +383,201 @@ def test_fix_forbid():
     circuit_finder.forbid_wire(1, 4)
     with pytest.raises(NoSolutionError):
         circuit_finder.find_circuit()
+
+
+def test_temporary_constraints():
+    tt = ["01101001"]
+    circuit_finder = CircuitFinderSat(TruthTableModel(tt), 6, basis=Basis.AIG)
+    circuit_finder.fix_gate(gate=4, first_predecessor=1, temporary=True)
+    circuit_finder.forbid_wire(1, 4, temporary=True)
+    with pytest.raises(NoSolutionError):
+        circuit_finder.find_circuit()
+
+    # Retracted constraints don't affect further searches on the same encoding.
+    circuit_finder.clear_temporary_constraints()
+    check_correctness(circuit_finder.find_circuit(), tt)
+
+    circuit_finder.forbid_wire(1, 3, temporary=True)
+    ckt = circuit_finder.find_circuit()
+    check_correctness(ckt, tt)
+    assert '1' not in ckt.get_gate('s3').operands
+    circuit_finder.close()
+
+
+def test_temporary_constraints_enumeration():
+    tt = ["0110"]
+    circuit_finder = CircuitFinderSat(TruthTableModel(tt), 1, basis=Basis.XAIG)
+    found = []
+    for gate_type in [_tt_to_gate_type[(0, 0, 0, 1)], _tt_to_gate_type[(0, 1, 1, 0)]]:
+        circuit_finder.clear_temporary_constraints()
+        circuit_finder.fix_gate(
+            gate=2,
+            first_predecessor=0,
+            second_predecessor=1,
+            gate_type=gate_type,
+            temporary=True,
+        )
+        try:
+            found.append(circuit_finder.find_circuit())
+        except NoSolutionError:
+            pass
+    assert len(found) == 1
+    check_correctness(found[0], tt)
+
+
+def test_max_depth():
+    # Sum of 3 bits is computed by 5 gates of depth 3, but not of depth 1.
+    tt = [
+        ''.join(str((sum(x) >> i) & 1) for x in itertools.product(range(2), repeat=3))
+        for i in range(2)
+    ]
+    circuit = CircuitFinderSat(
+        TruthTableModel(tt), 5, basis=Basis.XAIG, max_depth=3
+    ).find_circuit()
+    check_correctness(circuit, tt)
+    assert _circuit_depth(circuit) <= 3
+    with pytest.raises(NoSolutionError):
+        CircuitFinderSat(
+            TruthTableModel(tt), 5, basis=Basis.XAIG, max_depth=1
+        ).find_circuit()
+
+
+def test_size_depth_pareto_front():
+    # XOR of 4 bits: 3 gates in a chain (depth 3) or in a tree (depth 2).
+    tt = [
+        ''.join(str(sum(x) % 2) for x in itertools.product(range(2), repeat=4)),
+    ]
+    front = find_size_depth_pareto_front(
+        TruthTableModel(tt), max_size=5, basis=Basis.XAIG
+    )
+    assert [(c.gates_number(), _circuit_depth(c)) for c in front] == [(3, 2)]
+
+    # AND of 4 bits and XOR of its first 3 bits.
+    tt = [
+        ''.join(str(int(all(x))) for x in itertools.product(range(2), repeat=4)),
+        ''.join(str(sum(x[:3]) % 2) for x in itertools.product(range(2), repeat=4)),
+    ]
+    front = find_size_depth_pareto_front(
+        TruthTableModel(tt), max_size=6, basis=Basis.XAIG
+    )
+    for circuit in front:
+        check_correctness(circuit, tt)
+    sizes = [c.gates_number() for c in front]
+    depths = [_circuit_depth(c) for c in front]
+    assert all(lhs < rhs for lhs, rhs in zip(sizes, sizes[1:]))
+    assert all(lhs > rhs for lhs, rhs in zip(depths, depths[1:]))
+    assert depths[-1] == 2
+
+
+def test_find_min_size_circuit():
+    tt = [''.join(str(sum(x) % 2) for x in itertools.product(range(2), repeat=3))]
+    circuit = find_min_size_circuit(TruthTableModel(tt), max_size=4, max_depth=2)
+    check_correctness(circuit, tt)
+    assert circuit.gates_number() == 2
+    with pytest.raises(NoSolutionError):
+        find_min_size_circuit(TruthTableModel(tt), max_size=4, max_depth=1)
+
+
+def test_preprocessing():
+    tt = ["01101001"]
+    circuit_finder = CircuitFinderSat(TruthTableModel(tt), 2, basis=Basis.XAIG)
+    check_correctness(circuit_finder.find_circuit(preprocess=True), tt)
+    stats = circuit_finder.preprocessing_stats
+    assert stats is not None
+    assert stats.clauses_after <= stats.clauses_before
+
+    # Temporary constraints are taken into account by the preprocessed formula.
+    circuit_finder.forbid_wire(0, 3, temporary=True)
+    circuit_finder.forbid_wire(0, 4, temporary=True)
+    with pytest.raises(NoSolutionError):
+        circuit_finder.find_circuit(preprocess=True)
+    circuit_finder.clear_temporary_constraints()
+    check_correctness(circuit_finder.find_circuit(preprocess=True), tt)
+    circuit_finder.close()
+
+
+class _RecordingSolver:
+    """Solver which records calls made by `_solve_limited`."""
+
+    def __init__(self):
+        self.calls: tp.List[tp.Tuple] = []
+
+    def conf_budget(self, budget):
+        self.calls.append(('conf_budget', budget))
+
+    def prop_budget(self, budget):
+        self.calls.append(('prop_budget', budget))
+
+    def solve_limited(self, assumptions, expect_interrupt):
+        self.calls.append(('solve_limited', expect_interrupt))
+        return True
+
+    def interrupt(self):
+        pass
+
+    def clear_interrupt(self):
+        self.calls.append(('clear_interrupt',))
+
+
+def test_solve_limited_resets_budgets_and_releases_gil():
+    solver = _RecordingSolver()
+    assert _solve_limited(solver, conflict_budget=10)  # type: ignore
+    assert _solve_limited(solver)  # type: ignore
+    assert solver.calls == [
+        ('conf_budget', 10),
+        ('prop_budget', -1),
+        ('solve_limited', True),
+        ('clear_interrupt',),
+        ('conf_budget', -1),
+        ('prop_budget', -1),
+        ('solve_limited', True),
+        ('clear_interrupt',),
+    ]
+
+
+class _UnlimitedSolver:
+    """Solver which supports neither budgets nor interrupts, like Lingeling."""
+
+    def __init__(self):
+        self.assumptions: tp.Optional[tp.List[int]] = None
+
+    def conf_budget(self, budget):
+        raise NotImplementedError()
+
+    def prop_budget(self, budget):
+        raise NotImplementedError()
+
+    def solve(self, assumptions):
+        self.assumptions = assumptions
+        return True
+
+
+def test_solve_without_limits_support():
+    solver = _UnlimitedSolver()
+    assert _solve_limited(solver, assumptions=(1, -2))  # type: ignore
+    assert solver.assumptions == [1, -2]
+    with pytest.raises(NotImplementedError):
+        _solve_limited(solver, conflict_budget=10)  # type: ignore
+    with pytest.raises(NotImplementedError):
+        _solve_limited(solver, deadline=time.monotonic() + 10)  # type: ignore
+
+
+@pytest.mark.parametrize(
+    "solver_name",
+    [
+        PySATSolverNames.CADICAL103,
+        PySATSolverNames.CADICAL153,
+        PySATSolverNames.GLUCOSE4,
+        PySATSolverNames.LINGELING,
+    ],
+)
+def test_solvers_without_limits(solver_name: PySATSolverNames):
+    tt = [''.join(str(sum(x) % 2) for x in itertools.product(range(2), repeat=3))]
+    circuit = CircuitFinderSat(TruthTableModel(tt), 2, basis=Basis.XAIG).find_circuit(
+        solver_name=solver_name
+    )
+    check_correctness(circuit, tt)
+    with pytest.raises(NoSolutionError):
+        CircuitFinderSat(TruthTableModel(tt), 1, basis=Basis.XAIG).find_circuit(
+            solver_name=solver_name
+        )
@@ -0,0 +1,35 @@
+import pytest
+
+from extensions.abc_wrapper.src.abc import abc_memory_usage, abc_transform
+
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
+
+# Allowed growth of resident set size over the soak run. Some growth is expected due
+# to allocator fragmentation, but leaking even a single network per call exceeds it.
+_MAX_RSS_GROWTH_BYTES = 16 * 1024 * 1024
+
+
+@pytest.mark.ABC
+def test_abc_memory_usage():
+    assert abc_memory_usage() >= 0
+
+
+@pytest.mark.ABC
+@pytest.mark.slow
+@pytest.mark.parametrize("command", ["strash; dc2", "strash; fraig", "strash; rewrite"])
+def test_abc_soak(command: str):
+    circuit = generate_sum_n_bits(16)
+    if abc_memory_usage() == 0:
+        pytest.skip("resident set size can't be measured on this platform")
+
+    # Warm up, so that ABC's global frame and allocator pools are initialized.
+    for _ in range(100):
+        abc_transform(circuit, command)
+
+    samples = [abc_memory_usage()]
+    for _ in range(10):
+        for _ in range(200):
+            abc_transform(circuit, command)
+        samples.append(abc_memory_usage())
+
+    assert samples[-1] - samples[0] < _MAX_RSS_GROWTH_BYTES
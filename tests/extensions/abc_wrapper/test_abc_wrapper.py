@@ -10,7 +10,8 @@ try:
 except ImportError:
     pass
 
-from cirbo.core.circuit import AND, Circuit, Gate, INPUT, NOT, OR
+from cirbo.core.circuit import AND, Circuit, Gate, INPUT, NOT, NXOR, OR, XOR
+from cirbo.synthesis.generation.arithmetics import generate_sum_n_bits
 
 ckt1 = Circuit()
 ckt1.add_gate(Gate('x', INPUT))
@@ -89,3 +90,14 @@ def test_abc_simplify(circuit: Circuit, expected_size: int):
     simp_ckt = abc_transform(circuit, command)
     assert simp_ckt.get_truth_table() == circuit.get_truth_table()
     assert simp_ckt.gates_number() == expected_size
+
+
+@pytest.mark.ABC
+@pytest.mark.parametrize("command", ["strash", "strash; dc2", "strash; rewrite"])
+def test_abc_preserve_xor(command: str):
+    circuit = generate_sum_n_bits(4)
+    simp_ckt = abc_transform(circuit, command, preserve_xor=True)
+    aig_ckt = abc_transform(circuit, command)
+    assert simp_ckt.get_truth_table() == circuit.get_truth_table()
+    assert any(simp_ckt.get_gate(g).gate_type in (XOR, NXOR) for g in simp_ckt.gates)
+    assert simp_ckt.gates_number() < aig_ckt.gates_number()
@@ -0,0 +1,41 @@
+import pytest
+
+import mockturtle_wrapper as mw
+
+
+def test_bit_program():
+    # x0, x1, x2, then AND(x0, x1, x2), NOT of it, GT(x0, x1) and RIFF(x0, x2).
+    program = mw.BitProgram(
+        3,
+        [('AND', [0, 1, 2]), ('NOT', [3]), ('GT', [0, 1]), ('RIFF', [0, 2])],
+        [3, 4, 5, 6, 0],
+    )
+    assert program.input_size == 3
+    assert program.output_size == 5
+
+    assert program.evaluate([True, True, True]) == [True, False, False, True, True]
+    assert program.evaluate([True, False, False]) == [False, True, True, False, True]
+
+    size = 70
+    inputs = [(1 << size) - 1, 0x2AAAAAAAAAAAAAAAAA, 0x333333333333333333 >> 2]
+    outputs = program.evaluate_packed(
+        [vector.to_bytes(9, 'little') for vector in inputs], size
+    )
+    assert [int.from_bytes(output, 'little') for output in outputs] == [
+        inputs[1] & inputs[2],
+        (inputs[1] & inputs[2]) ^ ((1 << size) - 1),
+        inputs[0] & ~inputs[1],
+        inputs[2],
+        inputs[0],
+    ]
+
+
+def test_bit_program_errors():
+    with pytest.raises(ValueError):
+        mw.BitProgram(2, [('NOT', [0, 1])], [2])
+    with pytest.raises(ValueError):
+        mw.BitProgram(2, [('INPUT', [])], [2])
+    with pytest.raises(ValueError):
+        mw.BitProgram(2, [('AND', [0, 2])], [2])
+    with pytest.raises(ValueError):
+        mw.BitProgram(2, [('AND', [0, 1])], [3]).evaluate([True])
@@ -1,6 +1,18 @@
 import mockturtle_wrapper as mw
 from cirbo.core.circuit.circuit import Circuit
-from cirbo.core.circuit.gate import AND, Gate, INPUT, NOT, OR, XOR
+from cirbo.core.circuit.gate import (
+    ALWAYS_TRUE,
+    AND,
+    Gate,
+    GT,
+    INPUT,
+    LEQ,
+    LNOT,
+    NOT,
+    NXOR,
+    OR,
+    XOR,
+)
 
 
 def test_enumerate_cuts():
@@ -43,3 +55,30 @@ def test_enumerate_cuts():
         )
         == node_cuts
     )
+
+
+def test_enumerate_cuts_xaig_basis():
+    instance = Circuit()
+
+    instance.add_gate(Gate('A', INPUT))
+    instance.add_gate(Gate('B', INPUT))
+    instance.add_gate(Gate('C', INPUT))
+    instance.add_gate(Gate('D', GT, ('A', 'B')))
+    instance.add_gate(Gate('E', NXOR, ('D', 'C')))
+    instance.add_gate(Gate('F', LEQ, ('E', 'A')))
+    instance.add_gate(Gate('G', LNOT, ('F', 'B')))
+    instance.add_gate(Gate('H', ALWAYS_TRUE, ()))
+    instance.add_gate(Gate('I', XOR, ('G', 'H')))
+    instance.mark_as_output('I')
+
+    node_cuts = mw.enumerate_cuts(instance.format_circuit(), 5, 50, 10000)
+    node_cuts = {
+        node: set(frozenset(cut) for cut in cuts) for node, cuts in node_cuts.items()
+    }
+
+    assert frozenset({'A', 'B'}) in node_cuts['D']
+    assert frozenset({'C', 'D'}) in node_cuts['E']
+    assert frozenset({'A', 'B', 'C'}) in node_cuts['E']
+    assert frozenset({'A', 'E'}) in node_cuts['F']
+    assert frozenset({'B', 'F'}) in node_cuts['G']
+    assert frozenset({'A', 'B', 'C'}) in node_cuts['G']
@@ -0,0 +1,57 @@
+import pytest
+
+import mockturtle_wrapper as mw
+from cirbo.core.circuit.circuit import Circuit
+from cirbo.core.circuit.gate import AND, Gate, INPUT, NOT, OR, XOR
+
+
+def _make_circuit() -> Circuit:
+    instance = Circuit()
+
+    instance.add_gate(Gate('A', INPUT))
+    instance.add_gate(Gate('B', INPUT))
+    instance.add_gate(Gate('C', INPUT))
+    instance.add_gate(Gate('D', INPUT))
+    instance.add_gate(Gate('AB', AND, ('A', 'B')))
+    instance.add_gate(Gate('BC', AND, ('B', 'C')))
+    instance.add_gate(Gate('X', AND, ('AB', 'BC')))
+    instance.add_gate(Gate('NX', NOT, ('X',)))
+    instance.add_gate(Gate('Y', OR, ('NX', 'D')))
+    instance.add_gate(Gate('Z', XOR, ('Y', 'C')))
+    instance.mark_as_output('Z')
+    return instance
+
+
+def test_enumerate_windows():
+    assert callable(mw.enumerate_windows)
+
+    windows = {
+        (frozenset(leaves), frozenset(gates))
+        for leaves, gates in mw.enumerate_windows(
+            _make_circuit().format_circuit(), 4, 10, 1
+        )
+    }
+
+    # reconvergence through `B` and `C` is closed inside the windows
+    assert (
+        frozenset({'A', 'B', 'C'}),
+        frozenset({'AB', 'BC', 'X'}),
+    ) in windows
+    assert (
+        frozenset({'A', 'B', 'C', 'D'}),
+        frozenset({'AB', 'BC', 'X', 'NX', 'Y', 'Z'}),
+    ) in windows
+
+
+def test_enumerate_windows_limits():
+    for leaves, gates in mw.enumerate_windows(
+        _make_circuit().format_circuit(), 3, 2, 2
+    ):
+        assert 2 <= len(leaves) <= 3
+        assert len([gate for gate in gates if gate != 'NX']) <= 2
+        assert not set(leaves) & set(gates)
+
+
+def test_enumerate_windows_invalid_circuit():
+    with pytest.raises(ValueError):
+        mw.enumerate_windows('INPUT(A)\nB = AND(A,\n', 4, 10, 1)